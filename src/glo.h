@@ -1,10 +1,13 @@
 #ifndef __GLO_H__
 #define __GLO_H__
 
+#include <stdarg.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
 #define GLO_VERSION_INT	0x0001
 #define GLO_VERSION_STR	"0.1"
@@ -15,6 +18,11 @@
 #define ANIM_NAME_LEN 24
 #define TEX_NAME_LEN  16
 
+#define MAX_MESH_DEPTH 256
+
+// glo_save_txt flags
+#define GLO_TXT_EXACT 0x1
+
 #define R 0
 #define G 1
 #define B 2
@@ -28,12 +36,15 @@
 #define U 0
 #define V 1
 
-typedef packed {
+// In memory types are naturally aligned. The packed GLO_DISK_* records below
+// match the file layout and are only used when loading and saving.
+
+typedef struct {
 	char		magic[4];
 	uint16_t	version;
 } GLO_HEADER;
 
-typedef packed {
+typedef struct {
 	char	name[ANIM_NAME_LEN];
 	int		start;
 	int		end;
@@ -62,7 +73,7 @@ typedef union {
 	struct { uint8_t r, g, b, a; };
 } GLO_COLOR;
 
-typedef packed {
+typedef struct {
 	int time;
 	union {
 		GLO_VEC3 vert;
@@ -70,19 +81,19 @@ typedef packed {
 	};
 } GLO_KEYF;
 
-typedef packed {
+typedef struct {
 	uint16_t	index;
 	GLO_VEC2	uv;
 } GLO_VREF;
 
-typedef packed {
+typedef struct {
 	char		texture[TEX_NAME_LEN];
 	GLO_COLOR	color;
 	uint16_t	flags;
 	GLO_VREF	vrefs[3];
 } GLO_FACE;
 
-typedef packed {
+typedef struct {
 	char		texture[TEX_NAME_LEN];
 	GLO_COLOR	color;
 	GLO_VEC3	pos;
@@ -90,8 +101,8 @@ typedef packed {
 	uint16_t	flags;
 } GLO_SPRITE;
 
-typedef packed GLO_MESH GLO_MESH;
-typedef packed GLO_MESH {
+typedef struct GLO_MESH GLO_MESH;
+typedef struct GLO_MESH {
 	char		name[OBJ_NAME_LEN];
 	uint16_t	num_movekeys;
 	GLO_KEYF	*movekeys;
@@ -113,168 +124,645 @@ typedef packed GLO_MESH {
 	GLO_MESH	*next;
 } GLO_MESH;
 
-typedef packed {
+typedef struct {
 	uint16_t	num_anims;
 	GLO_ANIM	*anims;
 	uint16_t	num_meshes;
 	GLO_MESH	*meshes;
 } GLO_OBJECT;
 
-typedef packed {
+typedef struct {
 	GLO_HEADER	head;
 	uint16_t	num_objects;
 	GLO_OBJECT	*objects;
 } GLO_FILE;
 
+typedef packed {
+	char		magic[4];
+	uint16_t	version;
+} GLO_DISK_HEADER;
+
+typedef packed {
+	char		name[ANIM_NAME_LEN];
+	int32_t		start;
+	int32_t		end;
+	int32_t		flags;
+	float		speed;
+} GLO_DISK_ANIM;
+
+// Move and scale keys
+typedef packed {
+	int32_t		time;
+	float		v[3];
+} GLO_DISK_VKEY;
+
+// Rotate keys
+typedef packed {
+	int32_t		time;
+	float		v[4];
+} GLO_DISK_QKEY;
+
+typedef packed {
+	uint16_t	index;
+	float		uv[2];
+} GLO_DISK_VREF;
+
+typedef packed {
+	char			texture[TEX_NAME_LEN];
+	uint32_t		color;
+	uint16_t		flags;
+	GLO_DISK_VREF	vrefs[3];
+} GLO_DISK_FACE;
+
+typedef packed {
+	char		texture[TEX_NAME_LEN];
+	uint32_t	color;
+	float		pos[3];
+	float		size[2];
+	uint16_t	flags;
+} GLO_DISK_SPRITE;
+
+_Static_assert(sizeof(GLO_DISK_ANIM) == 40, "GLO_DISK_ANIM size");
+_Static_assert(sizeof(GLO_DISK_FACE) == 52, "GLO_DISK_FACE size");
+_Static_assert(sizeof(GLO_DISK_SPRITE) == 42, "GLO_DISK_SPRITE size");
+
+// Build with -DGLO_STATS to count and time what loading and saving spend
+// their time on. Without it the counters compile away to nothing.
+
+enum {
+	GLO_PHASE_READ,
+	GLO_PHASE_TOKENIZE,
+	GLO_PHASE_PARSE,
+	GLO_PHASE_ALLOC,
+	GLO_PHASE_WRITE,
+	GLO_NUM_PHASES
+};
+
+typedef struct {
+	uint64_t	ticks[GLO_NUM_PHASES];
+	uint64_t	bytes_read;
+	uint64_t	bytes_written;
+	uint64_t	tokens;
+	uint64_t	allocs;
+	uint64_t	alloc_bytes;
+	uint64_t	meshes;
+	uint64_t	faces;
+	uint64_t	vertices;
+} GLO_STATS_DATA;
+
+extern GLO_STATS_DATA glo_stats;
+extern const char *glo_phase_names[GLO_NUM_PHASES];
+
 GLO_FILE* glo_load(const char *fname);
-void glo_save(GLO_FILE *glo, const char *fname);
+// Same as glo_load for a GLO image already in memory
+GLO_FILE* glo_load_mem(const void *data, size_t size);
+int glo_save(GLO_FILE *glo, const char *fname);
 void glo_free(GLO_FILE *glo);
 void glo_free_mesh(GLO_MESH *mesh);
+GLO_FILE* glo_load_txt(const char *fname);
+int glo_save_txt(GLO_FILE *glo, const char *fname, int flags);
+GLO_FILE* glo_load_obj(const char *fname);
+int glo_save_obj(GLO_FILE *glo, const char *fname);
+int glo_validate(const void *data, size_t size, char *report, size_t report_len, int *warnings);
+
+// Byte offsets of a mesh in a GLO image. Its own data and children run from
+// start to next, and any siblings follow the has_next flag at next.
+typedef struct {
+	size_t	start;
+	size_t	child;
+	size_t	next;
+} GLO_MESH_SPAN;
+
+typedef struct {
+	void	*ctx;
+	// Either can be NULL. Meshes are reported after their children.
+	void	(*object)(void *ctx, int object, size_t start, size_t end);
+	void	(*mesh)(void *ctx, int object, int depth, const GLO_MESH_SPAN *span);
+} GLO_SCAN;
+
+int glo_scan(const void *data, size_t size, GLO_SCAN *scan);
 
 const char* glo_error();
 
 #ifdef GLO_IMPLEMENTATION
 
+// STATS
+
+GLO_STATS_DATA glo_stats;
+const char *glo_phase_names[GLO_NUM_PHASES] = { "read", "tokenize", "parse", "alloc", "write" };
+
+#ifdef GLO_STATS
+// Includers can supply a finer clock, clock() is the portable fallback
+#ifndef GLO_TICKS
+#define GLO_TICKS() ((uint64_t)clock())
+#define GLO_TICKS_PER_SEC CLOCKS_PER_SEC
+#endif
+// Counters are shared by every thread, so they're added atomically
+#define STAT_ADD(field, n) __sync_fetch_and_add(&glo_stats.field, (uint64_t)(n))
+#define STAT_START(name) uint64_t name = GLO_TICKS()
+#define STAT_STOP(phase, name) STAT_ADD(ticks[phase], GLO_TICKS() - name)
+#define STAT_TIME(phase, ...) { \
+	STAT_START(_start); \
+	__VA_ARGS__; \
+	STAT_STOP(phase, _start); \
+}
+
+static void* _glo_stat_alloc(void *res, size_t bytes) {
+	STAT_ADD(allocs, 1);
+	STAT_ADD(alloc_bytes, bytes);
+	return res;
+}
+
+static size_t _glo_stat_fread(void *ptr, size_t size, size_t n, FILE *f) {
+	size_t res;
+	STAT_TIME(GLO_PHASE_READ, res = fread(ptr, size, n, f));
+	STAT_ADD(bytes_read, res * size);
+	return res;
+}
+
+#define GLO_CALLOC(n, size) ({ void *_res; \
+	STAT_TIME(GLO_PHASE_ALLOC, _res = calloc(n, size)); \
+	_glo_stat_alloc(_res, (n) * (size)); })
+#define GLO_MALLOC(size) ({ void *_res; \
+	STAT_TIME(GLO_PHASE_ALLOC, _res = malloc(size)); \
+	_glo_stat_alloc(_res, size); })
+#define GLO_REALLOC(ptr, size) ({ void *_res; \
+	STAT_TIME(GLO_PHASE_ALLOC, _res = realloc(ptr, size)); \
+	_glo_stat_alloc(_res, size); })
+#define GLO_FREAD _glo_stat_fread
+#else
+#define STAT_ADD(field, n)
+#define STAT_START(name)
+#define STAT_STOP(phase, name)
+#define STAT_TIME(phase, ...) { __VA_ARGS__; }
+#define GLO_CALLOC calloc
+#define GLO_MALLOC malloc
+#define GLO_REALLOC realloc
+#define GLO_FREAD fread
+#endif
+
 #define ERRMSG_LEN	256
-char errmsg[ERRMSG_LEN] = {0};
+// Per thread so models can be loaded in parallel
+__thread char errmsg[ERRMSG_LEN] = {0};
 #define SETERR(...) snprintf(errmsg, ERRMSG_LEN, __VA_ARGS__)
 
 const char* glo_error() { return errmsg; }
 
 // GLO LOAD (binary)
 
-static void _glo_load_mesh(GLO_MESH *mesh, FILE *f) {
-	fread(mesh->name, 1, OBJ_NAME_LEN, f);
-	//printf(" %s\n", mesh->name);
-	fread(&mesh->num_movekeys, 1, sizeof(uint16_t), f);
-	//printf("  MoveKeys: %d\n", mesh->num_movekeys);
-	if(mesh->num_movekeys) {
-		mesh->movekeys = calloc(mesh->num_movekeys, sizeof(GLO_KEYF));
-		for(int k = 0; k < mesh->num_movekeys; k++) {
-			fread(&mesh->movekeys[k], 1, sizeof(int)+sizeof(GLO_VEC3), f);
-		}
-	}
-	fread(&mesh->num_scalekeys, 1, sizeof(uint16_t), f);
-	//printf("  ScaleKeys: %d\n", mesh->num_scalekeys);
-	if(mesh->num_scalekeys) {
-		mesh->scalekeys = calloc(mesh->num_scalekeys, sizeof(GLO_KEYF));
-		for(int k = 0; k < mesh->num_scalekeys; k++) {
-			fread(&mesh->scalekeys[k], 1, sizeof(int)+sizeof(GLO_VEC3), f);
-		}
-	}
-	fread(&mesh->num_rotatekeys, 1, sizeof(uint16_t), f);
-	//printf("  RotateKeys: %d\n", mesh->num_rotatekeys);
-	if(mesh->num_rotatekeys) {
-		mesh->rotatekeys = calloc(mesh->num_rotatekeys, sizeof(GLO_KEYF));
-		for(int k = 0; k < mesh->num_rotatekeys; k++) {
-			fread(&mesh->rotatekeys[k], 1, sizeof(int)+sizeof(GLO_QUAT), f);
-		}
-	}
-	fread(&mesh->num_vertices, 1, sizeof(uint16_t), f);
-	//printf("  Vertices: %d\n", mesh->num_vertices);
-	if(mesh->num_vertices) {
-		mesh->vertices = calloc(mesh->num_vertices, sizeof(GLO_VEC3));
-		fread(mesh->vertices, mesh->num_vertices, sizeof(GLO_VEC3), f);
-		//for(int i = 0; i < mesh->num_vertices; i++) {
-		//	printf("   %f, %f, %f\n", mesh->vertices[i].v[0],
-		//		mesh->vertices[i].v[1], mesh->vertices[i].v[2]);
-		//}
-	}
-	fread(&mesh->num_faces, 1, sizeof(uint16_t), f);
-	//printf("  Faces: %d\n", mesh->num_faces);
-	if(mesh->num_faces) {
-		mesh->faces = calloc(mesh->num_faces, sizeof(GLO_FACE));
-		fread(mesh->faces, mesh->num_faces, sizeof(GLO_FACE), f);
-		//for(int i = 0; i < mesh->num_faces; i++) {
-		//	GLO_FACE *face = &mesh->faces[i];
-		//	printf("   %d, %d, %d, %d\n", face->color.r,
-		//		face->color.g, face->color.b, face->color.a);
-		//	printf("    (%f, %f), (%f, %f), (%f, %f)\n", face->vrefs[0].uv.x,face->vrefs[0].uv.y,
-		//		face->vrefs[1].uv.x,face->vrefs[1].uv.y,face->vrefs[2].uv.x,face->vrefs[2].uv.y);
-		//}
-	}
-	fread(&mesh->num_sprites, 1, sizeof(uint16_t), f);
-	//printf("  Sprites: %d\n", mesh->num_sprites);
-	if(mesh->num_sprites) {
-		mesh->sprites = calloc(mesh->num_sprites, sizeof(GLO_SPRITE));
-		fread(mesh->sprites, mesh->num_sprites, sizeof(GLO_SPRITE), f);
-	}
-	fread(&mesh->xlu, 1, sizeof(uint16_t), f);
-	//printf("  Translucency: %d\n", mesh->xlu);
-	fread(&mesh->flags, 1, sizeof(uint16_t), f);
-	//printf("  Flags: %d\n", mesh->flags);
-	fread(&mesh->has_child, 1, sizeof(uint16_t), f);
-	//printf("  Child: %d\n", mesh->has_child);
-	if(mesh->has_child) {
-		mesh->child = calloc(1, sizeof(GLO_MESH));
-		_glo_load_mesh(mesh->child, f);
+// The whole file is read at once and records are decoded out of it, checking
+// there are enough bytes left for each.
+
+typedef struct {
+	const uint8_t	*data;
+	size_t			size;
+	size_t			pos;
+} GLO_READER;
+
+static const void* _glo_read(GLO_READER *r, size_t bytes) {
+	if(bytes > r->size - r->pos) {
+		SETERR("Unexpected end of file at %X.\n", (unsigned)r->pos);
+		return NULL;
 	}
-	fread(&mesh->has_next, 1, sizeof(uint16_t), f);
-	//printf("  Next: %d\n", mesh->has_next);
-	if(mesh->has_next) {
-		mesh->next = calloc(1, sizeof(GLO_MESH));
-		_glo_load_mesh(mesh->next, f);
+	const void *res = r->data + r->pos;
+	r->pos += bytes;
+	return res;
+}
+
+static int _glo_read16(GLO_READER *r, uint16_t *res) {
+	const void *src = _glo_read(r, sizeof(uint16_t));
+	if(!src) return 0;
+	memcpy(res, src, sizeof(uint16_t));
+	return 1;
+}
+
+static void _glo_decode_anim(GLO_ANIM *anim, const GLO_DISK_ANIM *disk) {
+	memcpy(anim->name, disk->name, ANIM_NAME_LEN);
+	anim->start = disk->start;
+	anim->end = disk->end;
+	anim->flags = disk->flags;
+	anim->speed = disk->speed;
+}
+
+static void _glo_decode_face(GLO_FACE *face, const GLO_DISK_FACE *disk) {
+	memcpy(face->texture, disk->texture, TEX_NAME_LEN);
+	face->color.c = disk->color;
+	face->flags = disk->flags;
+	for(int v = 0; v < 3; v++) {
+		face->vrefs[v].index = disk->vrefs[v].index;
+		face->vrefs[v].uv.x = disk->vrefs[v].uv[U];
+		face->vrefs[v].uv.y = disk->vrefs[v].uv[V];
+	}
+}
+
+static void _glo_decode_sprite(GLO_SPRITE *sprite, const GLO_DISK_SPRITE *disk) {
+	memcpy(sprite->texture, disk->texture, TEX_NAME_LEN);
+	sprite->color.c = disk->color;
+	memcpy(sprite->pos.v, disk->pos, sizeof(GLO_VEC3));
+	memcpy(sprite->size.v, disk->size, sizeof(GLO_VEC2));
+	sprite->flags = disk->flags;
+}
+
+static int _glo_load_keys(GLO_READER *r, uint16_t *count, GLO_KEYF **keys, int quat) {
+	if(!_glo_read16(r, count)) return 0;
+	if(!*count) return 1;
+	size_t keysize = quat ? sizeof(GLO_DISK_QKEY) : sizeof(GLO_DISK_VKEY);
+	const uint8_t *src = _glo_read(r, *count * keysize);
+	if(!src) return 0;
+	*keys = GLO_CALLOC(*count, sizeof(GLO_KEYF));
+	for(int k = 0; k < *count; k++, src += keysize) {
+		memcpy(&(*keys)[k].time, src, sizeof(int32_t));
+		memcpy((*keys)[k].quat.v, src + sizeof(int32_t), keysize - sizeof(int32_t));
+	}
+	return 1;
+}
+
+static int _glo_load_mesh(GLO_MESH *mesh, GLO_READER *r, int depth) {
+	if(depth >= MAX_MESH_DEPTH) {
+		SETERR("Mesh nesting deeper than %d.\n", MAX_MESH_DEPTH);
+		return 0;
+	}
+	const void *src;
+	uint16_t count;
+	// Siblings don't nest, so they're loaded in a loop instead of recursing
+	for(;;) {
+		if(!(src = _glo_read(r, OBJ_NAME_LEN))) return 0;
+		memcpy(mesh->name, src, OBJ_NAME_LEN);
+		//printf(" %s\n", mesh->name);
+		if(!_glo_load_keys(r, &mesh->num_movekeys, &mesh->movekeys, 0)) return 0;
+		if(!_glo_load_keys(r, &mesh->num_scalekeys, &mesh->scalekeys, 0)) return 0;
+		if(!_glo_load_keys(r, &mesh->num_rotatekeys, &mesh->rotatekeys, 1)) return 0;
+		if(!_glo_read16(r, &count)) return 0;
+		//printf("  Vertices: %d\n", count);
+		if(count) {
+			if(!(src = _glo_read(r, count * sizeof(GLO_VEC3)))) return 0;
+			mesh->vertices = GLO_MALLOC(count * sizeof(GLO_VEC3));
+			memcpy(mesh->vertices, src, count * sizeof(GLO_VEC3));
+			mesh->num_vertices = count;
+		}
+		if(!_glo_read16(r, &count)) return 0;
+		//printf("  Faces: %d\n", count);
+		if(count) {
+			if(!(src = _glo_read(r, count * sizeof(GLO_DISK_FACE)))) return 0;
+			mesh->faces = GLO_CALLOC(count, sizeof(GLO_FACE));
+			for(int i = 0; i < count; i++) {
+				_glo_decode_face(&mesh->faces[i], (const GLO_DISK_FACE*)src + i);
+			}
+			mesh->num_faces = count;
+		}
+		if(!_glo_read16(r, &count)) return 0;
+		//printf("  Sprites: %d\n", count);
+		if(count) {
+			if(!(src = _glo_read(r, count * sizeof(GLO_DISK_SPRITE)))) return 0;
+			mesh->sprites = GLO_CALLOC(count, sizeof(GLO_SPRITE));
+			for(int i = 0; i < count; i++) {
+				_glo_decode_sprite(&mesh->sprites[i], (const GLO_DISK_SPRITE*)src + i);
+			}
+			mesh->num_sprites = count;
+		}
+		if(!_glo_read16(r, &mesh->xlu)) return 0;
+		if(!_glo_read16(r, &mesh->flags)) return 0;
+		if(!_glo_read16(r, &count)) return 0;
+		if(count) {
+			mesh->has_child = 1;
+			mesh->child = GLO_CALLOC(1, sizeof(GLO_MESH));
+			if(!_glo_load_mesh(mesh->child, r, depth + 1)) return 0;
+		}
+		STAT_ADD(meshes, 1);
+		STAT_ADD(faces, mesh->num_faces);
+		STAT_ADD(vertices, mesh->num_vertices);
+		if(!_glo_read16(r, &count)) return 0;
+		if(!count) return 1;
+		mesh->has_next = 1;
+		mesh->next = GLO_CALLOC(1, sizeof(GLO_MESH));
+		mesh = mesh->next;
 	}
 }
 
+static int _glo_load_objects(GLO_FILE *glo, GLO_READER *r) {
+	const GLO_DISK_HEADER *head = _glo_read(r, sizeof(GLO_DISK_HEADER));
+	if(!head || memcmp(head->magic, "GLO", 4) != 0) {
+		SETERR("Invalid GLO header.\n");
+		return 0;
+	}
+	if(head->version != GLO_VERSION_INT) {
+		SETERR("Bad GLO version.\n");
+		return 0;
+	}
+	memcpy(glo->head.magic, head->magic, 4);
+	glo->head.version = head->version;
+	uint16_t count;
+	if(!_glo_read16(r, &count)) return 0;
+	//printf("Objects: %d\n", count);
+	glo->objects = GLO_CALLOC(count, sizeof(GLO_OBJECT));
+	glo->num_objects = count;
+	for(int o = 0; o < glo->num_objects; o++) {
+		GLO_OBJECT *obj = &glo->objects[o];
+		if(!_glo_read16(r, &count)) return 0;
+		//printf(" Anims: %d\n", count);
+		if(count) {
+			const GLO_DISK_ANIM *src = _glo_read(r, count * sizeof(GLO_DISK_ANIM));
+			if(!src) return 0;
+			obj->anims = GLO_CALLOC(count, sizeof(GLO_ANIM));
+			for(int a = 0; a < count; a++) _glo_decode_anim(&obj->anims[a], &src[a]);
+			obj->num_anims = count;
+		}
+		if(!_glo_read16(r, &count)) return 0;
+		//printf(" Meshes: %d\n", count);
+		if(count) {
+			obj->meshes = GLO_CALLOC(count, sizeof(GLO_MESH));
+			obj->num_meshes = count;
+			for(int m = 0; m < obj->num_meshes; m++) {
+				if(!_glo_load_mesh(&obj->meshes[m], r, 0)) return 0;
+			}
+		}
+	}
+	return 1;
+}
+
 GLO_FILE* glo_load(const char *fname) {
 	FILE *f = fopen(fname, "rb");
 	if(!f) {
 		SETERR("Failed to open '%s'.\n", fname);
 		return NULL;
 	}
-	GLO_FILE *glo = malloc(sizeof(GLO_FILE));
-	fread(&glo->head, 1, sizeof(GLO_HEADER), f);
-	if(strcmp(glo->head.magic, "GLO") != 0) {
-		free(glo);
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if(len <= 0) {
+		SETERR("File is empty or can't be read '%s'\n", fname);
 		fclose(f);
-		SETERR("Invalid GLO header.\n");
 		return NULL;
 	}
-	if(glo->head.version != GLO_VERSION_INT) {
-		free(glo);
-		fclose(f);
-		SETERR("Bad GLO version.\n");
+	uint8_t *data = GLO_MALLOC(len);
+	size_t size = GLO_FREAD(data, 1, len, f);
+	fclose(f);
+	GLO_FILE *glo = glo_load_mem(data, size);
+	free(data);
+	return glo;
+}
+
+GLO_FILE* glo_load_mem(const void *data, size_t size) {
+	GLO_READER r = { data, size, 0 };
+	GLO_FILE *glo = GLO_CALLOC(1, sizeof(GLO_FILE));
+	if(!_glo_load_objects(glo, &r)) {
+		glo_free(glo);
 		return NULL;
 	}
-	fread(&glo->num_objects, 1, sizeof(uint16_t), f);
-	//printf("Objects: %d\n", glo->num_objects);
-	glo->objects = calloc(glo->num_objects, sizeof(GLO_OBJECT));
-	for(int o = 0; o < glo->num_objects; o++) {
-		GLO_OBJECT *obj = &glo->objects[o];
-		fread(&obj->num_anims, 1, sizeof(uint16_t), f);
-		//printf(" Anims: %d\n", obj->num_anims);
-		if(obj->num_anims) {
-			obj->anims = calloc(obj->num_anims, sizeof(GLO_ANIM));
-			fread(obj->anims, obj->num_anims, sizeof(GLO_ANIM), f);
-		}
-		fread(&obj->num_meshes, 1, sizeof(uint16_t), f);
-		//printf(" Meshes: %d\n", obj->num_meshes);
-		if(obj->num_meshes) {
-			obj->meshes = calloc(obj->num_meshes, sizeof(GLO_MESH));
-			for(int m = 0; m < obj->num_meshes; m++) {
-				_glo_load_mesh(&obj->meshes[m], f);
+	return glo;
+}
+
+// MESH SPLITTING
+
+// Counts in GLO files are 16 bit. The text and OBJ loaders collect meshes
+// with int counts and indices, then store them here. Meshes over the limit
+// are split into chunks of nearby faces, each with the vertices it uses,
+// and chained as next siblings with the same keyframes.
+
+#define MAX_COUNT 0xFFFF
+
+typedef struct {
+	GLO_VEC3	*vertices;
+	int			num_vertices, cap_vertices;
+	GLO_FACE	*faces;
+	int			num_faces, cap_faces;
+	// Vertex index of each face corner, 3 per face
+	int			*corners;
+	int			cap_corners;
+	GLO_SPRITE	*sprites;
+	int			num_sprites, cap_sprites;
+} GLO_BIG_MESH;
+
+typedef struct {
+	float	key;
+	int		index;
+} GLO_SORT_KEY;
+
+typedef struct {
+	GLO_BIG_MESH	*big;
+	// Faces grouped by chunk, and where each chunk ends in it
+	int				*order;
+	int				*ends;
+	int				num_chunks;
+	int				*seen;
+	int				stamp;
+	GLO_SORT_KEY	*keys;
+} GLO_SPLITTER;
+
+static void* _glo_grow(void *arr, int *cap, int need, size_t size) {
+	if(need <= *cap) return arr;
+	while(*cap < need) *cap = *cap ? *cap * 2 : 256;
+	return GLO_REALLOC(arr, *cap * size);
+}
+
+static void _glo_big_free(GLO_BIG_MESH *big) {
+	free(big->vertices);
+	free(big->faces);
+	free(big->corners);
+	free(big->sprites);
+}
+
+static int _glo_sort_key_cmp(const void *a, const void *b) {
+	float x = ((const GLO_SORT_KEY*)a)->key, y = ((const GLO_SORT_KEY*)b)->key;
+	return x < y ? -1 : x > y;
+}
+
+// Counts the vertices used by faces [start, end) of order, leaving them
+// marked with the current stamp
+static int _glo_split_vertices(GLO_SPLITTER *s, int start, int end) {
+	int count = 0;
+	s->stamp++;
+	for(int i = start; i < end; i++) {
+		const int *corner = &s->big->corners[s->order[i] * 3];
+		for(int c = 0; c < 3; c++) {
+			if(s->seen[corner[c]] == s->stamp) continue;
+			s->seen[corner[c]] = s->stamp;
+			count++;
+		}
+	}
+	return count;
+}
+
+// Halves faces at the median of their centers along the longest axis until
+// every part fits
+static void _glo_split_faces(GLO_SPLITTER *s, int start, int end) {
+	if(end - start <= MAX_COUNT && _glo_split_vertices(s, start, end) <= MAX_COUNT) {
+		s->ends[s->num_chunks++] = end;
+		return;
+	}
+	const GLO_BIG_MESH *big = s->big;
+	float min[3], max[3];
+	for(int i = start; i < end; i++) {
+		const int *corner = &big->corners[s->order[i] * 3];
+		for(int a = 0; a < 3; a++) {
+			float center = big->vertices[corner[0]].v[a] + big->vertices[corner[1]].v[a]
+					+ big->vertices[corner[2]].v[a];
+			if(i == start || center < min[a]) min[a] = center;
+			if(i == start || center > max[a]) max[a] = center;
+		}
+	}
+	int axis = 0;
+	for(int a = 1; a < 3; a++) {
+		if(max[a] - min[a] > max[axis] - min[axis]) axis = a;
+	}
+	for(int i = start; i < end; i++) {
+		const int *corner = &big->corners[s->order[i] * 3];
+		s->keys[i].key = big->vertices[corner[0]].v[axis] + big->vertices[corner[1]].v[axis]
+				+ big->vertices[corner[2]].v[axis];
+		s->keys[i].index = s->order[i];
+	}
+	qsort(&s->keys[start], end - start, sizeof(GLO_SORT_KEY), _glo_sort_key_cmp);
+	for(int i = start; i < end; i++) s->order[i] = s->keys[i].index;
+	int mid = start + (end - start) / 2;
+	_glo_split_faces(s, start, mid);
+	_glo_split_faces(s, mid, end);
+}
+
+static GLO_KEYF* _glo_copy_keys(const GLO_KEYF *keys, int count) {
+	if(!count) return NULL;
+	GLO_KEYF *res = GLO_MALLOC(count * sizeof(GLO_KEYF));
+	memcpy(res, keys, count * sizeof(GLO_KEYF));
+	return res;
+}
+
+// name_1, name_2... cutting the name short so the suffix and a 0 fit
+static void _glo_chunk_name(char *res, const char *name, int chunk) {
+	char suffix[16];
+	int slen = snprintf(suffix, sizeof(suffix), "_%d", chunk);
+	const char *nul = memchr(name, 0, OBJ_NAME_LEN);
+	int len = nul ? nul - name : OBJ_NAME_LEN;
+	if(len > OBJ_NAME_LEN - 1 - slen) len = OBJ_NAME_LEN - 1 - slen;
+	memcpy(res, name, len);
+	memcpy(res + len, suffix, slen);
+}
+
+static GLO_MESH* _glo_split_mesh(GLO_MESH *mesh, GLO_BIG_MESH *big) {
+	int nv = big->num_vertices, nf = big->num_faces;
+	for(int i = 0; i < nf * 3; i++) {
+		if(big->corners[i] < 0 || big->corners[i] >= nv) {
+			SETERR("Mesh '%.*s' is too big and has bad vertex indices to split it by.\n", OBJ_NAME_LEN, mesh->name);
+			return NULL;
+		}
+	}
+	if(!nf && nv > MAX_COUNT) {
+		SETERR("Mesh '%.*s' has %d vertices and no faces to split it by.\n", OBJ_NAME_LEN, mesh->name, nv);
+		return NULL;
+	}
+	GLO_SPLITTER s = { big };
+	s.order = GLO_MALLOC((nf + 1) * sizeof(int));
+	s.ends = GLO_MALLOC((nf + 1) * sizeof(int));
+	s.seen = GLO_CALLOC(nv + 1, sizeof(int));
+	s.keys = GLO_MALLOC((nf + 1) * sizeof(GLO_SORT_KEY));
+	int *local = GLO_MALLOC((nv + 1) * sizeof(int));
+	for(int f = 0; f < nf; f++) s.order[f] = f;
+	if(nf) _glo_split_faces(&s, 0, nf);
+	// Sprites are shared out in file order
+	int num = (big->num_sprites + MAX_COUNT - 1) / MAX_COUNT;
+	if(num < s.num_chunks) num = s.num_chunks;
+	uint16_t has_next = mesh->has_next;
+	GLO_MESH *next = mesh->next, *last = NULL;
+	for(int k = 0; k < num; k++) {
+		GLO_MESH *chunk = mesh;
+		if(k) {
+			chunk = GLO_CALLOC(1, sizeof(GLO_MESH));
+			_glo_chunk_name(chunk->name, mesh->name, k);
+			chunk->num_movekeys = mesh->num_movekeys;
+			chunk->movekeys = _glo_copy_keys(mesh->movekeys, mesh->num_movekeys);
+			chunk->num_scalekeys = mesh->num_scalekeys;
+			chunk->scalekeys = _glo_copy_keys(mesh->scalekeys, mesh->num_scalekeys);
+			chunk->num_rotatekeys = mesh->num_rotatekeys;
+			chunk->rotatekeys = _glo_copy_keys(mesh->rotatekeys, mesh->num_rotatekeys);
+			chunk->xlu = mesh->xlu;
+			chunk->flags = mesh->flags;
+			last->has_next = 1;
+			last->next = chunk;
+		}
+		if(k < s.num_chunks) {
+			int start = k ? s.ends[k-1] : 0, end = s.ends[k];
+			chunk->num_vertices = _glo_split_vertices(&s, start, end);
+			chunk->vertices = GLO_MALLOC(chunk->num_vertices * sizeof(GLO_VEC3));
+			chunk->num_faces = end - start;
+			chunk->faces = GLO_MALLOC(chunk->num_faces * sizeof(GLO_FACE));
+			int count = 0;
+			s.stamp++;
+			for(int i = start; i < end; i++) {
+				GLO_FACE *face = &chunk->faces[i - start];
+				*face = big->faces[s.order[i]];
+				for(int c = 0; c < 3; c++) {
+					int v = big->corners[s.order[i] * 3 + c];
+					if(s.seen[v] != s.stamp) {
+						s.seen[v] = s.stamp;
+						local[v] = count;
+						chunk->vertices[count++] = big->vertices[v];
+					}
+					face->vrefs[c].index = local[v];
+				}
 			}
 		}
+		int first = k * MAX_COUNT;
+		if(first < big->num_sprites) {
+			chunk->num_sprites = big->num_sprites - first > MAX_COUNT ? MAX_COUNT : big->num_sprites - first;
+			chunk->sprites = GLO_MALLOC(chunk->num_sprites * sizeof(GLO_SPRITE));
+			memcpy(chunk->sprites, &big->sprites[first], chunk->num_sprites * sizeof(GLO_SPRITE));
+		}
+		STAT_ADD(meshes, 1);
+		STAT_ADD(faces, chunk->num_faces);
+		STAT_ADD(vertices, chunk->num_vertices);
+		last = chunk;
 	}
-	fclose(f);
-	return glo;
+	last->has_next = has_next;
+	last->next = next;
+	free(s.order);
+	free(s.ends);
+	free(s.seen);
+	free(s.keys);
+	free(local);
+	return last;
+}
+
+// Moves big's vertices, faces and sprites into mesh, splitting it if it's
+// too big. Returns the last chunk, or mesh itself if it fit. big's corners
+// are left for the caller to reuse or free.
+static GLO_MESH* _glo_store_mesh(GLO_MESH *mesh, GLO_BIG_MESH *big) {
+	GLO_MESH *last = mesh;
+	if(big->num_vertices <= MAX_COUNT && big->num_faces <= MAX_COUNT && big->num_sprites <= MAX_COUNT) {
+		for(int f = 0; f < big->num_faces; f++) {
+			for(int c = 0; c < 3; c++) big->faces[f].vrefs[c].index = big->corners[f * 3 + c];
+		}
+		mesh->num_vertices = big->num_vertices;
+		mesh->vertices = big->vertices;
+		mesh->num_faces = big->num_faces;
+		mesh->faces = big->faces;
+		mesh->num_sprites = big->num_sprites;
+		mesh->sprites = big->sprites;
+		STAT_ADD(meshes, 1);
+		STAT_ADD(faces, mesh->num_faces);
+		STAT_ADD(vertices, mesh->num_vertices);
+		// Owned by mesh now, unless it's empty and glo_free won't free it
+		if(!mesh->num_vertices) free(big->vertices);
+		if(!mesh->num_faces) free(big->faces);
+		if(!mesh->num_sprites) free(big->sprites);
+	} else {
+		last = _glo_split_mesh(mesh, big);
+		free(big->vertices);
+		free(big->faces);
+		free(big->sprites);
+	}
+	big->vertices = NULL;
+	big->faces = NULL;
+	big->sprites = NULL;
+	big->num_vertices = big->cap_vertices = 0;
+	big->num_faces = big->cap_faces = 0;
+	big->num_sprites = big->cap_sprites = 0;
+	return last;
 }
 
 // GLO LOAD (text)
 
 #define isspace(x) ((x) == ' ' || (x) == '\t' || (x) == '\r' || (x) == '\n')
 
-static int txtln;
-static char token[80];
-
-#define ALLOC_OBJ	256
-#define ALLOC_ANIM	256
-#define ALLOC_MESH	256
-#define ALLOC_KEYF	256
-#define ALLOC_VTX	256
-#define ALLOC_FACE	256
-#define ALLOC_SPR	256
+static __thread int txtln;
+static __thread char token[80];
 
 static char* _wsp(char *pos) {
 	for(;;) {
@@ -295,6 +783,7 @@ static char* _wsp(char *pos) {
 static int _tklen(char *pos) {
 	int len = 0;
 	for(;;) {
+		if(pos[len] == 0) return len;
 		if(pos[0] == '"') { // Strings might have spaces
 			if(len > 0 && pos[len] == '"') return len+1;
 		} else {
@@ -307,13 +796,15 @@ static int _tklen(char *pos) {
 #define NEXT_LINE { \
 	while(*pos != '\n' && *pos != 0) pos++; \
 }
-#define NEXT_TOKEN { \
+#define NEXT_TOKEN STAT_TIME(GLO_PHASE_TOKENIZE, { \
 	pos = _wsp(pos); \
 	int len = _tklen(pos); \
-	strncpy(token, pos, len); \
-	token[len] = 0; \
+	int keep = len < (int)sizeof(token) ? len : (int)sizeof(token) - 1; \
+	strncpy(token, pos, keep); \
+	token[keep] = 0; \
 	pos += len; \
-}
+	STAT_ADD(tokens, 1); \
+})
 #define CMP_TOKEN(str) (strcmp(token, str) == 0)
 #define ASSERT_TOKEN(str, ...) if(!CMP_TOKEN(str)) { \
 	SETERR(__VA_ARGS__); \
@@ -321,99 +812,118 @@ static int _tklen(char *pos) {
 }
 
 #define PARSE_STRING(res, maxlen) { \
-	if(token[0] != '"') { \
-		SETERR("%d: Expected string.\n", txtln); \
-		return NULL; \
-	} \
-	int len = 0; \
-	while(token[len+1] != '"') { \
-		if(len >= maxlen) { \
-			SETERR("%d: String too long, max %d.\n", txtln, maxlen); \
+	if(token[0] == '#') { \
+		if(!_glo_parse_hex(token+1, res, maxlen)) { \
+			SETERR("%d: Bad hex string, max %d bytes.\n", txtln, maxlen); \
 			return NULL; \
 		} \
-		len++; \
+	} else { \
+		if(token[0] != '"') { \
+			SETERR("%d: Expected string.\n", txtln); \
+			return NULL; \
+		} \
+		int len = 0; \
+		while(token[len+1] != '"') { \
+			if(token[len+1] == 0) { \
+				SETERR("%d: String not closed.\n", txtln); \
+				return NULL; \
+			} \
+			if(len >= maxlen) { \
+				SETERR("%d: String too long, max %d.\n", txtln, maxlen); \
+				return NULL; \
+			} \
+			len++; \
+		} \
+		strncpy(res, token+1, len); \
+		if(len < maxlen) res[len] = 0; \
 	} \
-	strncpy(res, token+1, len); \
-	res[len] = 0; \
 }
 #define PARSE_NUM(res, fmt, ...) { \
-	int num = sscanf(token, fmt, &res); \
+	int num; \
+	STAT_TIME(GLO_PHASE_PARSE, num = sscanf(token, fmt, &res)); \
 	if(!num) { \
 		SETERR(__VA_ARGS__); \
 		return NULL; \
 	} \
 }
 
-static char* _glo_load_mesh_txt(GLO_MESH *mesh, char *pos) {
-	NEXT_TOKEN;
-	PARSE_STRING(mesh->name, OBJ_NAME_LEN);
-	NEXT_TOKEN;
-	PARSE_NUM(mesh->xlu, "%hX", "%d: Bad 'xlu' for 'mesh'\n", txtln);
-	NEXT_TOKEN;
-	PARSE_NUM(mesh->flags, "%hX", "%d: Bad 'flags' for 'mesh'\n", txtln);
-	NEXT_TOKEN;
-	ASSERT_TOKEN("{", "%d: Expected '{'\n", txtln);
-	NEXT_TOKEN;
-	while(CMP_TOKEN("movekey")) {
-		if(!mesh->num_movekeys) mesh->movekeys = calloc(ALLOC_KEYF, sizeof(GLO_KEYF));
-		GLO_KEYF *key = &mesh->movekeys[mesh->num_movekeys];
-		mesh->num_movekeys++;
-		NEXT_TOKEN;
-		PARSE_NUM(key->time, "%d", "%d: Bad 'time' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->vert.x, "%f", "%d: Bad 'x' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->vert.y, "%f", "%d: Bad 'y' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->vert.z, "%f", "%d: Bad 'z' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-	}
-	while(CMP_TOKEN("scalekey")) {
-		if(!mesh->num_scalekeys) mesh->scalekeys = calloc(ALLOC_KEYF, sizeof(GLO_KEYF));
-		GLO_KEYF *key = &mesh->scalekeys[mesh->num_scalekeys];
-		mesh->num_scalekeys++;
-		NEXT_TOKEN;
-		PARSE_NUM(key->time, "%d", "%d: Bad 'time' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->vert.x, "%f", "%d: Bad 'x' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->vert.y, "%f", "%d: Bad 'y' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->vert.z, "%f", "%d: Bad 'z' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
+// Adds a zeroed element to arr, failing past the 16 bit counts of the format
+#define ADD_ITEM(arr, count, cap, res, what) { \
+	if(count == MAX_COUNT) { \
+		SETERR("%d: More than %d %s.\n", txtln, MAX_COUNT, what); \
+		return NULL; \
+	} \
+	arr = _glo_grow(arr, &cap, count + 1, sizeof(*arr)); \
+	res = &arr[count++]; \
+	memset(res, 0, sizeof(*res)); \
+}
+
+static int _glo_hex_digit(char c) {
+	if(c >= '0' && c <= '9') return c - '0';
+	if(c >= 'A' && c <= 'F') return c - 'A' + 10;
+	if(c >= 'a' && c <= 'f') return c - 'a' + 10;
+	return -1;
+}
+
+// Exact floats are written as '#' and the 8 hex digits of their bits
+static int _glo_parse_bits(const char *str, float *res) {
+	uint32_t bits = 0;
+	for(int i = 0; i < 8; i++) {
+		int digit = _glo_hex_digit(str[i]);
+		if(digit < 0) return 0;
+		bits = bits << 4 | digit;
 	}
-	while(CMP_TOKEN("rotatekey")) {
-		if(!mesh->num_rotatekeys) mesh->rotatekeys = calloc(ALLOC_KEYF, sizeof(GLO_KEYF));
-		GLO_KEYF *key = &mesh->rotatekeys[mesh->num_rotatekeys];
-		mesh->num_rotatekeys++;
-		NEXT_TOKEN;
-		PARSE_NUM(key->time, "%d", "%d: Bad 'time' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->quat.x, "%f", "%d: Bad 'x' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->quat.y, "%f", "%d: Bad 'y' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->quat.z, "%f", "%d: Bad 'z' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
-		PARSE_NUM(key->quat.w, "%f", "%d: Bad 'w' for 'keyframe'.\n", txtln);
-		NEXT_TOKEN;
+	if(str[8] != 0) return 0;
+	memcpy(res, &bits, sizeof(float));
+	return 1;
+}
+
+// Exact names that can't be quoted are written as '#' and two hex digits per
+// byte, bytes left out are zero
+static int _glo_parse_hex(const char *str, char *res, int maxlen) {
+	int len = 0;
+	for(; str[len * 2]; len++) {
+		if(len >= maxlen) return 0;
+		int hi = _glo_hex_digit(str[len * 2]), lo = _glo_hex_digit(str[len * 2 + 1]);
+		if(hi < 0 || lo < 0) return 0;
+		res[len] = (char)(hi << 4 | lo);
 	}
+	memset(res + len, 0, maxlen - len);
+	return 1;
+}
+
+#define PARSE_FLOAT(res, ...) { \
+	if(token[0] == '#') { \
+		float bits; \
+		int ok; \
+		STAT_TIME(GLO_PHASE_PARSE, ok = _glo_parse_bits(token+1, &bits)); \
+		if(!ok) { \
+			SETERR(__VA_ARGS__); \
+			return NULL; \
+		} \
+		res = bits; \
+	} else PARSE_NUM(res, "%f", __VA_ARGS__); \
+}
+
+// Vertices, faces and sprites, which may be more than a mesh can hold
+static char* _glo_load_geometry_txt(GLO_BIG_MESH *big, char *pos) {
 	while(CMP_TOKEN("vertex")) {
-		if(!mesh->num_vertices) mesh->vertices = calloc(ALLOC_VTX, sizeof(GLO_VEC3));
-		GLO_VEC3 *vtx = &mesh->vertices[mesh->num_vertices];
-		mesh->num_vertices++;
+		big->vertices = _glo_grow(big->vertices, &big->cap_vertices, big->num_vertices + 1, sizeof(GLO_VEC3));
+		GLO_VEC3 *vtx = &big->vertices[big->num_vertices++];
 		NEXT_TOKEN;
-		PARSE_NUM(vtx->x, "%f", "%d: Bad 'x' for 'vertex'.\n", txtln);
+		PARSE_FLOAT(vtx->x, "%d: Bad 'x' for 'vertex'.\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(vtx->y, "%f", "%d: Bad 'y' for 'vertex'.\n", txtln);
+		PARSE_FLOAT(vtx->y, "%d: Bad 'y' for 'vertex'.\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(vtx->z, "%f", "%d: Bad 'z' for 'vertex'.\n", txtln);
+		PARSE_FLOAT(vtx->z, "%d: Bad 'z' for 'vertex'.\n", txtln);
 		NEXT_TOKEN;
 	}
 	while(CMP_TOKEN("face")) {
-		if(!mesh->num_faces) mesh->faces = calloc(ALLOC_FACE, sizeof(GLO_FACE));
-		GLO_FACE *face = &mesh->faces[mesh->num_faces];
-		mesh->num_faces++;
+		big->faces = _glo_grow(big->faces, &big->cap_faces, big->num_faces + 1, sizeof(GLO_FACE));
+		big->corners = _glo_grow(big->corners, &big->cap_corners, (big->num_faces + 1) * 3, sizeof(int));
+		int *corners = &big->corners[big->num_faces * 3];
+		GLO_FACE *face = &big->faces[big->num_faces++];
+		memset(face, 0, sizeof(GLO_FACE));
 		NEXT_TOKEN;
 		PARSE_STRING(face->texture, TEX_NAME_LEN);
 		NEXT_TOKEN;
@@ -426,20 +936,20 @@ static char* _glo_load_mesh_txt(GLO_MESH *mesh, char *pos) {
 		for(int i = 0; i < 3; i++) {
 			ASSERT_TOKEN("vref", "%d: Expected vref.\n", txtln);
 			NEXT_TOKEN;
-			PARSE_NUM(face->vrefs[i].index, "%hd", "%d: Bad index for 'vref'\n", txtln);
+			PARSE_NUM(corners[i], "%d", "%d: Bad index for 'vref'\n", txtln);
 			NEXT_TOKEN;
-			PARSE_NUM(face->vrefs[i].uv.x, "%f", "%d: Bad 'u' for 'vref'\n", txtln);
+			PARSE_FLOAT(face->vrefs[i].uv.x, "%d: Bad 'u' for 'vref'\n", txtln);
 			NEXT_TOKEN;
-			PARSE_NUM(face->vrefs[i].uv.y, "%f", "%d: Bad 'v' for 'vref'\n", txtln);
+			PARSE_FLOAT(face->vrefs[i].uv.y, "%d: Bad 'v' for 'vref'\n", txtln);
 			NEXT_TOKEN;
 		}
 		ASSERT_TOKEN("}", "%d: Face vrefs not closed.\n", txtln);
 		NEXT_TOKEN;
 	}
 	while(CMP_TOKEN("sprite")) {
-		if(!mesh->num_sprites) mesh->sprites = calloc(ALLOC_SPR, sizeof(GLO_SPRITE));
-		GLO_SPRITE *sprite = &mesh->sprites[mesh->num_sprites];
-		mesh->num_sprites++;
+		big->sprites = _glo_grow(big->sprites, &big->cap_sprites, big->num_sprites + 1, sizeof(GLO_SPRITE));
+		GLO_SPRITE *sprite = &big->sprites[big->num_sprites++];
+		memset(sprite, 0, sizeof(GLO_SPRITE));
 		NEXT_TOKEN;
 		PARSE_STRING(sprite->texture, TEX_NAME_LEN);
 		NEXT_TOKEN;
@@ -447,28 +957,88 @@ static char* _glo_load_mesh_txt(GLO_MESH *mesh, char *pos) {
 		NEXT_TOKEN;
 		PARSE_NUM(sprite->flags, "%hX", "%d: Bad flag for 'sprite'\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(sprite->pos.x, "%f", "%d: Bad 'x pos' for 'sprite'\n", txtln);
+		PARSE_FLOAT(sprite->pos.x, "%d: Bad 'x pos' for 'sprite'\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(sprite->pos.y, "%f", "%d: Bad 'y pos' for 'sprite'\n", txtln);
+		PARSE_FLOAT(sprite->pos.y, "%d: Bad 'y pos' for 'sprite'\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(sprite->pos.z, "%f", "%d: Bad 'z pos' for 'sprite'\n", txtln);
+		PARSE_FLOAT(sprite->pos.z, "%d: Bad 'z pos' for 'sprite'\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(sprite->size.x, "%f", "%d: Bad 'x size' for 'sprite'\n", txtln);
+		PARSE_FLOAT(sprite->size.x, "%d: Bad 'x size' for 'sprite'\n", txtln);
 		NEXT_TOKEN;
-		PARSE_NUM(sprite->size.y, "%f", "%d: Bad 'y size' for 'sprite'\n", txtln);
+		PARSE_FLOAT(sprite->size.y, "%d: Bad 'y size' for 'sprite'\n", txtln);
 		NEXT_TOKEN;
 	}
+	return pos;
+}
+
+static char* _glo_load_mesh_txt(GLO_MESH *mesh, char *pos) {
+	NEXT_TOKEN;
+	PARSE_STRING(mesh->name, OBJ_NAME_LEN);
+	NEXT_TOKEN;
+	PARSE_NUM(mesh->xlu, "%hX", "%d: Bad 'xlu' for 'mesh'\n", txtln);
+	NEXT_TOKEN;
+	PARSE_NUM(mesh->flags, "%hX", "%d: Bad 'flags' for 'mesh'\n", txtln);
+	NEXT_TOKEN;
+	ASSERT_TOKEN("{", "%d: Expected '{'\n", txtln);
+	NEXT_TOKEN;
+	int cap_move = 0, cap_scale = 0, cap_rotate = 0;
+	GLO_KEYF *key;
+	while(CMP_TOKEN("movekey")) {
+		ADD_ITEM(mesh->movekeys, mesh->num_movekeys, cap_move, key, "movekeys");
+		NEXT_TOKEN;
+		PARSE_NUM(key->time, "%d", "%d: Bad 'time' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->vert.x, "%d: Bad 'x' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->vert.y, "%d: Bad 'y' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->vert.z, "%d: Bad 'z' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+	}
+	while(CMP_TOKEN("scalekey")) {
+		ADD_ITEM(mesh->scalekeys, mesh->num_scalekeys, cap_scale, key, "scalekeys");
+		NEXT_TOKEN;
+		PARSE_NUM(key->time, "%d", "%d: Bad 'time' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->vert.x, "%d: Bad 'x' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->vert.y, "%d: Bad 'y' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->vert.z, "%d: Bad 'z' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+	}
+	while(CMP_TOKEN("rotatekey")) {
+		ADD_ITEM(mesh->rotatekeys, mesh->num_rotatekeys, cap_rotate, key, "rotatekeys");
+		NEXT_TOKEN;
+		PARSE_NUM(key->time, "%d", "%d: Bad 'time' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->quat.x, "%d: Bad 'x' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->quat.y, "%d: Bad 'y' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->quat.z, "%d: Bad 'z' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+		PARSE_FLOAT(key->quat.w, "%d: Bad 'w' for 'keyframe'.\n", txtln);
+		NEXT_TOKEN;
+	}
+	// Stored before the child and next are read, so any extra chunks go
+	// between this mesh and its next
+	GLO_BIG_MESH big = {0};
+	pos = _glo_load_geometry_txt(&big, pos);
+	GLO_MESH *last = pos ? _glo_store_mesh(mesh, &big) : NULL;
+	_glo_big_free(&big);
+	if(!last) return NULL;
 	if(CMP_TOKEN("child")) {
 		mesh->has_child = 1;
-		mesh->child = calloc(1, sizeof(GLO_MESH));
+		mesh->child = GLO_CALLOC(1, sizeof(GLO_MESH));
 		pos = _glo_load_mesh_txt(mesh->child, pos);
 		if(!pos) return NULL;
 		NEXT_TOKEN;
 	}
 	if(CMP_TOKEN("next")) {
-		mesh->has_next = 1;
-		mesh->next = calloc(1, sizeof(GLO_MESH));
-		pos = _glo_load_mesh_txt(mesh->next, pos);
+		last->has_next = 1;
+		last->next = GLO_CALLOC(1, sizeof(GLO_MESH));
+		pos = _glo_load_mesh_txt(last->next, pos);
 		if(!pos) return NULL;
 		NEXT_TOKEN;
 	}
@@ -476,41 +1046,19 @@ static char* _glo_load_mesh_txt(GLO_MESH *mesh, char *pos) {
 	return pos;
 }
 
-GLO_FILE *glo_load_txt(const char *fname) {
-	FILE *f = fopen(fname, "rb");
-	if(!f) {
-		SETERR("Failed to open '%s'.\n", fname);
-		return NULL;
-	}
-	fseek(f, 0, SEEK_END);
-	int len = ftell(f);
-	if (!len) {
-		SETERR("File is empty '%s'\n", fname);
-		fclose(f);
-		return NULL;
-	}
-	fseek(f, 0, SEEK_SET);
-	char *txt = malloc(len+1);
-	fread(txt, 1, len, f);
-	txt[len] = 0;
-	fclose(f);
-	GLO_FILE *glo = calloc(1, sizeof(GLO_FILE));
-	strcpy(glo->head.magic, "GLO");
-	glo->head.version = GLO_VERSION_INT;
-	char *pos = txt;
-	txtln = 1;
+static char* _glo_load_objects_txt(GLO_FILE *glo, char *pos) {
+	int cap_objects = 0;
 	NEXT_TOKEN;
 	while(CMP_TOKEN("object")) {
-		if(!glo->num_objects) glo->objects = calloc(ALLOC_OBJ, sizeof(GLO_OBJECT));
-		GLO_OBJECT *obj = &glo->objects[glo->num_objects];
-		glo->num_objects++;
+		GLO_OBJECT *obj;
+		ADD_ITEM(glo->objects, glo->num_objects, cap_objects, obj, "objects");
+		int cap_anims = 0, cap_meshes = 0;
 		NEXT_TOKEN;
 		ASSERT_TOKEN("{", "%d: Expected '{' after 'object'\n", txtln);
 		NEXT_TOKEN;
 		while(CMP_TOKEN("anim")) {
-			if(!obj->num_anims) obj->anims = calloc(ALLOC_ANIM, sizeof(GLO_ANIM));
-			GLO_ANIM *anim = &obj->anims[obj->num_anims];
-			obj->num_anims++;
+			GLO_ANIM *anim;
+			ADD_ITEM(obj->anims, obj->num_anims, cap_anims, anim, "anims");
 			NEXT_TOKEN;
 			PARSE_STRING(anim->name, ANIM_NAME_LEN);
 			NEXT_TOKEN;
@@ -520,13 +1068,12 @@ GLO_FILE *glo_load_txt(const char *fname) {
 			NEXT_TOKEN;
 			PARSE_NUM(anim->flags, "%X", "%d: Bad 'flags' for 'anim'\n", txtln);
 			NEXT_TOKEN;
-			PARSE_NUM(anim->speed, "%f", "%d: Bad 'speed' for 'anim'\n", txtln);
+			PARSE_FLOAT(anim->speed, "%d: Bad 'speed' for 'anim'\n", txtln);
 			NEXT_TOKEN;
 		}
 		while(CMP_TOKEN("mesh")) {
-			if(!obj->num_meshes) obj->meshes = calloc(ALLOC_MESH, sizeof(GLO_MESH));
-			GLO_MESH *mesh = &obj->meshes[obj->num_meshes];
-			obj->num_meshes++;
+			GLO_MESH *mesh;
+			ADD_ITEM(obj->meshes, obj->num_meshes, cap_meshes, mesh, "meshes");
 			pos = _glo_load_mesh_txt(mesh, pos);
 			if(!pos) return NULL;
 			NEXT_TOKEN;
@@ -534,60 +1081,402 @@ GLO_FILE *glo_load_txt(const char *fname) {
 		ASSERT_TOKEN("}", "%d: Object not closed.\n", txtln);
 		NEXT_TOKEN;
 	}
+	return pos;
+}
+
+GLO_FILE *glo_load_txt(const char *fname) {
+	FILE *f = fopen(fname, "rb");
+	if(!f) {
+		SETERR("Failed to open '%s'.\n", fname);
+		return NULL;
+	}
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	if (len <= 0) {
+		SETERR("File is empty or can't be read '%s'\n", fname);
+		fclose(f);
+		return NULL;
+	}
+	fseek(f, 0, SEEK_SET);
+	char *txt = GLO_MALLOC(len+1);
+	GLO_FREAD(txt, 1, len, f);
+	txt[len] = 0;
+	fclose(f);
+	GLO_FILE *glo = GLO_CALLOC(1, sizeof(GLO_FILE));
+	strcpy(glo->head.magic, "GLO");
+	glo->head.version = GLO_VERSION_INT;
+	txtln = 1;
+	char *pos = _glo_load_objects_txt(glo, txt);
 	free(txt);
+	if(!pos) {
+		glo_free(glo);
+		return NULL;
+	}
 	return glo;
 }
 
+// GLO LOAD (obj)
+
+// Wavefront OBJ import. Each 'o' or 'g' starts a new mesh, 'usemtl' sets the
+// texture of the faces that follow and polygons are fanned into triangles.
+// OBJ vertices are shared by the whole file, so each mesh keeps a hash of
+// OBJ index -> mesh vertex to pull in only the ones it uses, once each.
+
+typedef struct {
+	int key;
+	int val;
+} GLO_HASH_SLOT;
+
+typedef struct {
+	GLO_HASH_SLOT	*slots;
+	int				mask;
+	int				count;
+} GLO_HASH;
+
+static uint32_t _glo_hash_int(int key) { return (uint32_t)key * 2654435761u; }
+
+static void _glo_hash_clear(GLO_HASH *h) {
+	if(!h->slots) {
+		h->mask = 1023;
+		h->slots = GLO_MALLOC((h->mask + 1) * sizeof(GLO_HASH_SLOT));
+	}
+	for(int i = 0; i <= h->mask; i++) h->slots[i].key = -1;
+	h->count = 0;
+}
+
+// Returns the slot for key, which has key -1 if it's not in the table yet
+static GLO_HASH_SLOT* _glo_hash_find(GLO_HASH *h, int key) {
+	if(h->count * 2 > h->mask) {
+		GLO_HASH old = *h;
+		h->mask = h->mask * 2 + 1;
+		h->slots = GLO_MALLOC((h->mask + 1) * sizeof(GLO_HASH_SLOT));
+		for(int i = 0; i <= h->mask; i++) h->slots[i].key = -1;
+		for(int i = 0; i <= old.mask; i++) {
+			if(old.slots[i].key < 0) continue;
+			*_glo_hash_find(h, old.slots[i].key) = old.slots[i];
+		}
+		free(old.slots);
+	}
+	uint32_t i = _glo_hash_int(key) & h->mask;
+	while(h->slots[i].key >= 0 && h->slots[i].key != key) i = (i + 1) & h->mask;
+	return &h->slots[i];
+}
+
+typedef struct {
+	GLO_FILE	*glo;
+	GLO_MESH	*mesh;
+	int			cap_meshes;
+	GLO_BIG_MESH big;
+	float		*pos;
+	int			num_pos, cap_pos;
+	float		*uv;
+	int			num_uv, cap_uv;
+	GLO_HASH	remap;
+	char		texture[TEX_NAME_LEN];
+	int			line;
+} GLO_OBJ_READER;
+
+static int _glo_obj_end_mesh(GLO_OBJ_READER *r) {
+	GLO_MESH *mesh = r->mesh;
+	if(!mesh) return 1;
+	r->mesh = NULL;
+	return _glo_store_mesh(mesh, &r->big) != NULL;
+}
+
+static int _glo_obj_begin_mesh(GLO_OBJ_READER *r, const char *name, int len) {
+	GLO_OBJECT *obj = &r->glo->objects[0];
+	// Groups with no faces yet (like a 'g' straight after an 'o') only rename
+	if(!r->mesh || r->big.num_faces) {
+		if(!_glo_obj_end_mesh(r)) return 0;
+		if(obj->num_meshes == MAX_COUNT) {
+			SETERR("%d: More than %d meshes.\n", r->line, MAX_COUNT);
+			return 0;
+		}
+		obj->meshes = _glo_grow(obj->meshes, &r->cap_meshes, obj->num_meshes + 1, sizeof(GLO_MESH));
+		r->mesh = &obj->meshes[obj->num_meshes++];
+		memset(r->mesh, 0, sizeof(GLO_MESH));
+		_glo_hash_clear(&r->remap);
+	}
+	// 'o' or 'g' with nothing after it gets the same name as an unnamed start
+	if(len <= 0) {
+		name = "obj";
+		len = 3;
+	}
+	if(len >= OBJ_NAME_LEN) len = OBJ_NAME_LEN - 1;
+	memset(r->mesh->name, 0, OBJ_NAME_LEN);
+	memcpy(r->mesh->name, name, len);
+	return 1;
+}
+
+static const char* _glo_obj_int(const char *pos, int *res) {
+	char *end;
+	*res = strtol(pos, &end, 10);
+	return end == pos ? NULL : end;
+}
+
+// Resolves 1-based or negative OBJ indices against count
+static int _glo_obj_index(int index, int count) {
+	if(index < 0) index += count;
+	else index--;
+	return index >= 0 && index < count ? index : -1;
+}
+
+static int _glo_obj_face(GLO_OBJ_READER *r, const char *pos, const char *end) {
+	if(!r->mesh && !_glo_obj_begin_mesh(r, "obj", 3)) return 0;
+	GLO_BIG_MESH *big = &r->big;
+	GLO_VREF first, prev;
+	int corners = 0, first_index = 0, prev_index = 0;
+	for(;;) {
+		while(pos < end && (*pos == ' ' || *pos == '\t')) pos++;
+		if(pos >= end) break;
+		int v, t = 0;
+		pos = _glo_obj_int(pos, &v);
+		if(!pos || (v = _glo_obj_index(v, r->num_pos)) < 0) {
+			SETERR("%d: Bad vertex index for 'f'.\n", r->line);
+			return 0;
+		}
+		if(*pos == '/') {
+			pos++;
+			if(*pos != '/') {
+				pos = _glo_obj_int(pos, &t);
+				if(!pos || (t = _glo_obj_index(t, r->num_uv)) < 0) {
+					SETERR("%d: Bad texture index for 'f'.\n", r->line);
+					return 0;
+				}
+				t++;
+			}
+			// Normals are ignored
+			while(pos < end && *pos != ' ' && *pos != '\t') pos++;
+		}
+		GLO_HASH_SLOT *slot = _glo_hash_find(&r->remap, v);
+		if(slot->key < 0) {
+			slot->key = v;
+			slot->val = big->num_vertices;
+			r->remap.count++;
+			big->vertices = _glo_grow(big->vertices, &big->cap_vertices,
+					big->num_vertices + 1, sizeof(GLO_VEC3));
+			memcpy(&big->vertices[big->num_vertices++], &r->pos[v * 3], sizeof(GLO_VEC3));
+		}
+		GLO_VREF vref = {0};
+		if(t) {
+			vref.uv.x = r->uv[(t-1) * 2];
+			vref.uv.y = 1.0f - r->uv[(t-1) * 2 + 1];
+		}
+		if(corners == 0) {
+			first = vref;
+			first_index = slot->val;
+		}
+		if(corners >= 2) {
+			big->faces = _glo_grow(big->faces, &big->cap_faces, big->num_faces + 1, sizeof(GLO_FACE));
+			big->corners = _glo_grow(big->corners, &big->cap_corners, (big->num_faces + 1) * 3, sizeof(int));
+			int *corner = &big->corners[big->num_faces * 3];
+			GLO_FACE *face = &big->faces[big->num_faces++];
+			memset(face, 0, sizeof(GLO_FACE));
+			memcpy(face->texture, r->texture, TEX_NAME_LEN);
+			face->color.c = 0xFFFFFFFF;
+			face->vrefs[0] = first;
+			face->vrefs[1] = prev;
+			face->vrefs[2] = vref;
+			corner[0] = first_index;
+			corner[1] = prev_index;
+			corner[2] = slot->val;
+		}
+		prev = vref;
+		prev_index = slot->val;
+		corners++;
+	}
+	if(corners < 3) {
+		SETERR("%d: Face with less than 3 vertices.\n", r->line);
+		return 0;
+	}
+	return 1;
+}
+
+static int _glo_obj_floats(const char *pos, float *res, int count) {
+	for(int i = 0; i < count; i++) {
+		char *end;
+		res[i] = strtof(pos, &end);
+		if(end == pos) return 0;
+		pos = end;
+	}
+	return 1;
+}
+
+static int _glo_load_obj(GLO_OBJ_READER *r, const char *txt, const char *eof) {
+	for(const char *pos = txt; pos < eof; r->line++) {
+		const char *end = memchr(pos, '\n', eof - pos);
+		if(!end) end = eof;
+		const char *next = end + 1;
+		while(pos < end && (*pos == ' ' || *pos == '\t')) pos++;
+		while(end > pos && (end[-1] == '\r' || end[-1] == ' ' || end[-1] == '\t')) end--;
+		if(pos[0] == 'v' && pos[1] == ' ') {
+			r->pos = _glo_grow(r->pos, &r->cap_pos, r->num_pos + 1, 3 * sizeof(float));
+			if(!_glo_obj_floats(pos + 2, &r->pos[r->num_pos++ * 3], 3)) {
+				SETERR("%d: Bad 'v'.\n", r->line);
+				return 0;
+			}
+		} else if(pos[0] == 'v' && pos[1] == 't' && pos[2] == ' ') {
+			r->uv = _glo_grow(r->uv, &r->cap_uv, r->num_uv + 1, 2 * sizeof(float));
+			if(!_glo_obj_floats(pos + 3, &r->uv[r->num_uv++ * 2], 2)) {
+				SETERR("%d: Bad 'vt'.\n", r->line);
+				return 0;
+			}
+		} else if(pos[0] == 'f' && pos[1] == ' ') {
+			if(!_glo_obj_face(r, pos + 2, end)) return 0;
+		} else if((pos[0] == 'o' || pos[0] == 'g') && pos[1] == ' ') {
+			if(!_glo_obj_begin_mesh(r, pos + 2, end - pos - 2)) return 0;
+		} else if(strncmp(pos, "usemtl ", 7) == 0) {
+			int len = end - pos - 7;
+			if(len < 0) len = 0;
+			if(len > TEX_NAME_LEN) {
+				SETERR("%d: Material name too long, max %d.\n", r->line, TEX_NAME_LEN);
+				return 0;
+			}
+			memset(r->texture, 0, TEX_NAME_LEN);
+			memcpy(r->texture, pos + 7, len);
+		}
+		pos = next;
+	}
+	return _glo_obj_end_mesh(r);
+}
+
+GLO_FILE* glo_load_obj(const char *fname) {
+	FILE *f = fopen(fname, "rb");
+	if(!f) {
+		SETERR("Failed to open '%s'.\n", fname);
+		return NULL;
+	}
+	fseek(f, 0, SEEK_END);
+	long len = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if(len <= 0) {
+		SETERR("File is empty or can't be read '%s'\n", fname);
+		fclose(f);
+		return NULL;
+	}
+	char *txt = GLO_MALLOC(len + 1);
+	GLO_FREAD(txt, 1, len, f);
+	txt[len] = 0;
+	fclose(f);
+	GLO_OBJ_READER r = {0};
+	r.line = 1;
+	r.glo = GLO_CALLOC(1, sizeof(GLO_FILE));
+	strcpy(r.glo->head.magic, "GLO");
+	r.glo->head.version = GLO_VERSION_INT;
+	r.glo->num_objects = 1;
+	r.glo->objects = GLO_CALLOC(1, sizeof(GLO_OBJECT));
+	int ok = _glo_load_obj(&r, txt, txt + len);
+	// Whatever wasn't stored in a mesh yet
+	_glo_big_free(&r.big);
+	free(txt);
+	free(r.pos);
+	free(r.uv);
+	free(r.remap.slots);
+	if(!ok) {
+		glo_free(r.glo);
+		return NULL;
+	}
+	return r.glo;
+}
+
 // GLO SAVE (binary)
 
-static void _glo_save_mesh(GLO_MESH *mesh, FILE *f) {
-	fwrite(mesh->name, 1, OBJ_NAME_LEN, f);
-	fwrite(&mesh->num_movekeys, 1, sizeof(uint16_t), f);
-	for(int k = 0; k < mesh->num_movekeys; k++) {
-		fwrite(&mesh->movekeys[k], 1, sizeof(int)+sizeof(GLO_VEC3), f);
+static void _glo_encode_anim(GLO_DISK_ANIM *disk, const GLO_ANIM *anim) {
+	memcpy(disk->name, anim->name, ANIM_NAME_LEN);
+	disk->start = anim->start;
+	disk->end = anim->end;
+	disk->flags = anim->flags;
+	disk->speed = anim->speed;
+}
+
+static void _glo_encode_face(GLO_DISK_FACE *disk, const GLO_FACE *face) {
+	memcpy(disk->texture, face->texture, TEX_NAME_LEN);
+	disk->color = face->color.c;
+	disk->flags = face->flags;
+	for(int v = 0; v < 3; v++) {
+		disk->vrefs[v].index = face->vrefs[v].index;
+		disk->vrefs[v].uv[U] = face->vrefs[v].uv.x;
+		disk->vrefs[v].uv[V] = face->vrefs[v].uv.y;
 	}
-	fwrite(&mesh->num_scalekeys, 1, sizeof(uint16_t), f);
-	for(int k = 0; k < mesh->num_scalekeys; k++) {
-		fwrite(&mesh->scalekeys[k], 1, sizeof(int)+sizeof(GLO_VEC3), f);
+}
+
+static void _glo_encode_sprite(GLO_DISK_SPRITE *disk, const GLO_SPRITE *sprite) {
+	memcpy(disk->texture, sprite->texture, TEX_NAME_LEN);
+	disk->color = sprite->color.c;
+	memcpy(disk->pos, sprite->pos.v, sizeof(GLO_VEC3));
+	memcpy(disk->size, sprite->size.v, sizeof(GLO_VEC2));
+	disk->flags = sprite->flags;
+}
+
+static void _glo_save_keys(uint16_t count, GLO_KEYF *keys, int quat, FILE *f) {
+	fwrite(&count, 1, sizeof(uint16_t), f);
+	for(int k = 0; k < count; k++) {
+		GLO_DISK_QKEY disk;
+		disk.time = keys[k].time;
+		memcpy(disk.v, keys[k].quat.v, sizeof(GLO_QUAT));
+		fwrite(&disk, 1, quat ? sizeof(GLO_DISK_QKEY) : sizeof(GLO_DISK_VKEY), f);
 	}
-	fwrite(&mesh->num_rotatekeys, 1, sizeof(uint16_t), f);
-	for(int k = 0; k < mesh->num_rotatekeys; k++) {
-		fwrite(&mesh->rotatekeys[k], 1, sizeof(int)+sizeof(GLO_QUAT), f);
-	}
-	fwrite(&mesh->num_vertices, 1, sizeof(uint16_t), f);
-	fwrite(mesh->vertices, mesh->num_vertices, sizeof(GLO_VEC3), f);
-	fwrite(&mesh->num_faces, 1, sizeof(uint16_t), f);
-	fwrite(mesh->faces, mesh->num_faces, sizeof(GLO_FACE), f);
-	fwrite(&mesh->num_sprites, 1, sizeof(uint16_t), f);
-	fwrite(mesh->sprites, mesh->num_sprites, sizeof(GLO_SPRITE), f);
-	fwrite(&mesh->xlu, 1, sizeof(uint16_t), f);
-	fwrite(&mesh->flags, 1, sizeof(uint16_t), f);
-	fwrite(&mesh->has_child, 1, sizeof(uint16_t), f);
-	if(mesh->has_child) _glo_save_mesh(mesh->child, f);
-	fwrite(&mesh->has_next, 1, sizeof(uint16_t), f);
-	if(mesh->has_next) _glo_save_mesh(mesh->next, f);
-}
-
-void glo_save(GLO_FILE *glo, const char *fname) {
+}
+
+static void _glo_save_mesh(GLO_MESH *mesh, FILE *f) {
+	for(;;) {
+		fwrite(mesh->name, 1, OBJ_NAME_LEN, f);
+		_glo_save_keys(mesh->num_movekeys, mesh->movekeys, 0, f);
+		_glo_save_keys(mesh->num_scalekeys, mesh->scalekeys, 0, f);
+		_glo_save_keys(mesh->num_rotatekeys, mesh->rotatekeys, 1, f);
+		fwrite(&mesh->num_vertices, 1, sizeof(uint16_t), f);
+		if(mesh->num_vertices) fwrite(mesh->vertices, mesh->num_vertices, sizeof(GLO_VEC3), f);
+		fwrite(&mesh->num_faces, 1, sizeof(uint16_t), f);
+		for(int i = 0; i < mesh->num_faces; i++) {
+			GLO_DISK_FACE disk;
+			_glo_encode_face(&disk, &mesh->faces[i]);
+			fwrite(&disk, 1, sizeof(GLO_DISK_FACE), f);
+		}
+		fwrite(&mesh->num_sprites, 1, sizeof(uint16_t), f);
+		for(int i = 0; i < mesh->num_sprites; i++) {
+			GLO_DISK_SPRITE disk;
+			_glo_encode_sprite(&disk, &mesh->sprites[i]);
+			fwrite(&disk, 1, sizeof(GLO_DISK_SPRITE), f);
+		}
+		fwrite(&mesh->xlu, 1, sizeof(uint16_t), f);
+		fwrite(&mesh->flags, 1, sizeof(uint16_t), f);
+		fwrite(&mesh->has_child, 1, sizeof(uint16_t), f);
+		if(mesh->has_child) _glo_save_mesh(mesh->child, f);
+		fwrite(&mesh->has_next, 1, sizeof(uint16_t), f);
+		if(!mesh->has_next) return;
+		mesh = mesh->next;
+	}
+}
+
+int glo_save(GLO_FILE *glo, const char *fname) {
 	FILE *f = fopen(fname, "wb");
 	if(!f) {
 		SETERR("Failed to open '%s'.\n", fname);
-		return;
+		return 0;
 	}
-	fwrite(&glo->head, 1, sizeof(GLO_HEADER), f);
+	STAT_START(start);
+	GLO_DISK_HEADER head;
+	memcpy(head.magic, glo->head.magic, 4);
+	head.version = glo->head.version;
+	fwrite(&head, 1, sizeof(GLO_DISK_HEADER), f);
 	fwrite(&glo->num_objects, 1, sizeof(uint16_t), f);
 	for(int i = 0; i < glo->num_objects; i++) {
 		GLO_OBJECT *obj = &glo->objects[i];
 		fwrite(&obj->num_anims, 1, sizeof(uint16_t), f);
 		for(int a = 0; a < obj->num_anims; a++) {
-			fwrite(&obj->anims[a], 1, sizeof(GLO_ANIM), f);
+			GLO_DISK_ANIM disk;
+			_glo_encode_anim(&disk, &obj->anims[a]);
+			fwrite(&disk, 1, sizeof(GLO_DISK_ANIM), f);
 		}
 		fwrite(&obj->num_meshes, 1, sizeof(uint16_t), f);
 		for(int m = 0; m < obj->num_meshes; m++) {
 			_glo_save_mesh(&obj->meshes[m], f);
 		}
 	}
+	STAT_ADD(bytes_written, ftell(f));
 	fclose(f);
+	STAT_STOP(GLO_PHASE_WRITE, start);
+	return 1;
 }
 
 // GLO SAVE (text)
@@ -597,42 +1486,90 @@ static void newline(FILE *txt, int tabs) {
 	for(int i = 0; i < tabs; i++) fprintf(txt, "\t");
 }
 
-static void glo_save_txt_mesh(GLO_MESH *mesh, FILE *txt, int tabs) {
-	fprintf(txt, "\"%s\" %04X %04X {", mesh->name, mesh->xlu, mesh->flags);
+// With GLO_TXT_EXACT floats are written as their raw bits, which reads back
+// exactly and skips decimal conversion both ways.
+static void _glo_save_float(FILE *txt, float x, int flags) {
+	if(flags & GLO_TXT_EXACT) {
+		static const char hex[] = "0123456789ABCDEF";
+		uint32_t bits;
+		memcpy(&bits, &x, sizeof(float));
+		char str[11] = " #";
+		for(int i = 0; i < 8; i++) str[2+i] = hex[bits >> (28 - i*4) & 0xF];
+		str[10] = 0;
+		fputs(str, txt);
+	} else {
+		fprintf(txt, " %f", x);
+	}
+}
+
+// With GLO_TXT_EXACT a name that quotes would lose something, like bytes after
+// its terminator or a quote, is written as '#' and the hex of its bytes.
+static void _glo_save_name(FILE *txt, const char *name, int len, int flags) {
+	int end = 0, last = 0;
+	while(end < len && name[end]) end++;
+	int plain = 1;
+	for(int i = 0; i < len; i++) {
+		if(name[i]) last = i + 1;
+		if(i < end ? name[i] == '"' || (unsigned char)name[i] < ' ' : name[i] != 0) plain = 0;
+	}
+	if(plain || !(flags & GLO_TXT_EXACT)) {
+		fprintf(txt, "\"%.*s\"", len, name);
+		return;
+	}
+	fputc('#', txt);
+	for(int i = 0; i < last; i++) fprintf(txt, "%02X", (unsigned char)name[i]);
+}
+
+static void glo_save_txt_mesh(GLO_MESH *mesh, FILE *txt, int tabs, int flags) {
+	_glo_save_name(txt, mesh->name, OBJ_NAME_LEN, flags);
+	fprintf(txt, " %04X %04X {", mesh->xlu, mesh->flags);
 	tabs++;
 	for(int k = 0; k < mesh->num_movekeys; k++) {
 		GLO_KEYF *key = &mesh->movekeys[k];
 		newline(txt, tabs);
-		fprintf(txt, "movekey %d %f %f %f", key->time, 
-				key->vert.x, key->vert.y, key->vert.z);
+		fprintf(txt, "movekey %d", key->time);
+		_glo_save_float(txt, key->vert.x, flags);
+		_glo_save_float(txt, key->vert.y, flags);
+		_glo_save_float(txt, key->vert.z, flags);
 	}
 	for(int k = 0; k < mesh->num_scalekeys; k++) {
 		GLO_KEYF *key = &mesh->scalekeys[k];
 		newline(txt, tabs);
-		fprintf(txt, "scalekey %d %f %f %f", key->time, 
-				key->vert.x, key->vert.y, key->vert.z);
+		fprintf(txt, "scalekey %d", key->time);
+		_glo_save_float(txt, key->vert.x, flags);
+		_glo_save_float(txt, key->vert.y, flags);
+		_glo_save_float(txt, key->vert.z, flags);
 	}
 	for(int k = 0; k < mesh->num_rotatekeys; k++) {
 		GLO_KEYF *key = &mesh->rotatekeys[k];
 		newline(txt, tabs);
-		fprintf(txt, "rotatekey %d %f %f %f %f", key->time, 
-				key->quat.x, key->quat.y, key->quat.z, key->quat.w);
+		fprintf(txt, "rotatekey %d", key->time);
+		_glo_save_float(txt, key->quat.x, flags);
+		_glo_save_float(txt, key->quat.y, flags);
+		_glo_save_float(txt, key->quat.z, flags);
+		_glo_save_float(txt, key->quat.w, flags);
 	}
 	for(int v = 0; v < mesh->num_vertices; v++) {
 		GLO_VEC3 *vtx = &mesh->vertices[v];
 		newline(txt, tabs);
-		fprintf(txt, "vertex %f %f %f", vtx->x, vtx->y, vtx->z);
+		fprintf(txt, "vertex");
+		_glo_save_float(txt, vtx->x, flags);
+		_glo_save_float(txt, vtx->y, flags);
+		_glo_save_float(txt, vtx->z, flags);
 	}
 	for(int f = 0; f < mesh->num_faces; f++) {
 		GLO_FACE *face = &mesh->faces[f];
 		newline(txt, tabs);
-		fprintf(txt, "face \"%s\" %08X %04X {", 
-				face->texture, face->color.c, face->flags);
+		fprintf(txt, "face ");
+		_glo_save_name(txt, face->texture, TEX_NAME_LEN, flags);
+		fprintf(txt, " %08X %04X {", face->color.c, face->flags);
 		tabs++;
 		for(int v = 0; v < 3; v++) {
 			GLO_VREF *vref = &face->vrefs[v];
 			newline(txt, tabs);
-			fprintf(txt, "vref %d %f %f", vref->index, vref->uv.x, vref->uv.y);
+			fprintf(txt, "vref %d", vref->index);
+			_glo_save_float(txt, vref->uv.x, flags);
+			_glo_save_float(txt, vref->uv.y, flags);
 		}
 		tabs--;
 		newline(txt, tabs);
@@ -641,34 +1578,39 @@ static void glo_save_txt_mesh(GLO_MESH *mesh, FILE *txt, int tabs) {
 	for(int s = 0; s < mesh->num_sprites; s++) {
 		GLO_SPRITE *sprite = &mesh->sprites[s];
 		newline(txt, tabs);
-		fprintf(txt, "sprite \"%s\" %08X %04X %f %f %f %f %f", 
-				sprite->texture, sprite->color.c, sprite->flags,
-				sprite->pos.x, sprite->pos.y, sprite->pos.z, 
-				sprite->size.x, sprite->size.y);
+		fprintf(txt, "sprite ");
+		_glo_save_name(txt, sprite->texture, TEX_NAME_LEN, flags);
+		fprintf(txt, " %08X %04X", sprite->color.c, sprite->flags);
+		_glo_save_float(txt, sprite->pos.x, flags);
+		_glo_save_float(txt, sprite->pos.y, flags);
+		_glo_save_float(txt, sprite->pos.z, flags);
+		_glo_save_float(txt, sprite->size.x, flags);
+		_glo_save_float(txt, sprite->size.y, flags);
 	}
 	if(mesh->has_child) {
 		GLO_MESH *child = mesh->child;
 		newline(txt, tabs);
 		fprintf(txt, "child ");
-		glo_save_txt_mesh(child, txt, tabs);
+		glo_save_txt_mesh(child, txt, tabs, flags);
 	}
 	if(mesh->has_next) {
 		GLO_MESH *next = mesh->next;
 		newline(txt, tabs);
 		fprintf(txt, "next ");
-		glo_save_txt_mesh(next, txt, tabs);
+		glo_save_txt_mesh(next, txt, tabs, flags);
 	}
 	tabs--;
 	newline(txt, tabs);
 	fprintf(txt, "}");
 }
 
-void glo_save_txt(GLO_FILE *glo, const char *fname) {
+int glo_save_txt(GLO_FILE *glo, const char *fname, int flags) {
 	FILE *txt = fopen(fname, "w");
 	if(!txt) {
 		SETERR("Failed to open '%s'.\n", fname);
-		return;
+		return 0;
 	}
+	STAT_START(start);
 	fprintf(txt, "; %s - %s\n", fname, GLO_VERSION_STR);
 	int tabs = 0;
 	for(int o = 0; o < glo->num_objects; o++) {
@@ -679,34 +1621,112 @@ void glo_save_txt(GLO_FILE *glo, const char *fname) {
 		for(int a = 0; a < obj->num_anims; a++) {
 			GLO_ANIM *anim = &obj->anims[a];
 			newline(txt, tabs);
-			fprintf(txt, "anim \"%s\" %d %d %d %f", anim->name,
-					anim->start, anim->end, anim->flags, anim->speed);
+			fprintf(txt, "anim ");
+			_glo_save_name(txt, anim->name, ANIM_NAME_LEN, flags);
+			fprintf(txt, " %d %d %X", anim->start, anim->end, anim->flags);
+			_glo_save_float(txt, anim->speed, flags);
 		}
 		for(int m = 0; m < obj->num_meshes; m++) {
 			GLO_MESH *mesh = &obj->meshes[m];
 			newline(txt, tabs);
 			fprintf(txt, "mesh ");
-			glo_save_txt_mesh(mesh, txt, tabs);
+			glo_save_txt_mesh(mesh, txt, tabs, flags);
 		}
 		tabs--;
 		newline(txt, tabs);
 		fprintf(txt, "}");
 	}
 	newline(txt, tabs);
+	STAT_ADD(bytes_written, ftell(txt));
 	fclose(txt);
+	STAT_STOP(GLO_PHASE_WRITE, start);
+	return 1;
+}
+
+// GLO SAVE (obj)
+
+// Meshes are written in their own local space, so keyframe offsets between
+// parts of the hierarchy are not applied.
+
+typedef struct {
+	FILE	*f;
+	int		num_vertices;
+	int		num_uvs;
+	char	texture[TEX_NAME_LEN];
+} GLO_OBJ_WRITER;
+
+static void _glo_save_obj_mesh(GLO_OBJ_WRITER *w, GLO_MESH *mesh) {
+	for(; mesh; mesh = mesh->has_next ? mesh->next : NULL) {
+		fprintf(w->f, "o %.*s\n", OBJ_NAME_LEN, mesh->name);
+		for(int v = 0; v < mesh->num_vertices; v++) {
+			GLO_VEC3 *vtx = &mesh->vertices[v];
+			fprintf(w->f, "v %.9g %.9g %.9g\n", vtx->x, vtx->y, vtx->z);
+		}
+		for(int f = 0; f < mesh->num_faces; f++) {
+			GLO_FACE *face = &mesh->faces[f];
+			for(int v = 0; v < 3; v++) {
+				fprintf(w->f, "vt %.9g %.9g\n", face->vrefs[v].uv.x, 1.0f - face->vrefs[v].uv.y);
+			}
+		}
+		for(int f = 0; f < mesh->num_faces; f++) {
+			GLO_FACE *face = &mesh->faces[f];
+			if(strncmp(face->texture, w->texture, TEX_NAME_LEN) != 0) {
+				memcpy(w->texture, face->texture, TEX_NAME_LEN);
+				fprintf(w->f, "usemtl %.*s\n", TEX_NAME_LEN, face->texture);
+			}
+			int uv = w->num_uvs + f * 3 + 1;
+			fprintf(w->f, "f %d/%d %d/%d %d/%d\n",
+					w->num_vertices + face->vrefs[0].index + 1, uv,
+					w->num_vertices + face->vrefs[1].index + 1, uv + 1,
+					w->num_vertices + face->vrefs[2].index + 1, uv + 2);
+		}
+		w->num_vertices += mesh->num_vertices;
+		w->num_uvs += mesh->num_faces * 3;
+		if(mesh->has_child) _glo_save_obj_mesh(w, mesh->child);
+	}
+}
+
+int glo_save_obj(GLO_FILE *glo, const char *fname) {
+	GLO_OBJ_WRITER w = {0};
+	w.f = fopen(fname, "w");
+	if(!w.f) {
+		SETERR("Failed to open '%s'.\n", fname);
+		return 0;
+	}
+	STAT_START(start);
+	fprintf(w.f, "# %s - %s\n", fname, GLO_VERSION_STR);
+	for(int o = 0; o < glo->num_objects; o++) {
+		GLO_OBJECT *obj = &glo->objects[o];
+		for(int m = 0; m < obj->num_meshes; m++) {
+			_glo_save_obj_mesh(&w, &obj->meshes[m]);
+		}
+	}
+	STAT_ADD(bytes_written, ftell(w.f));
+	fclose(w.f);
+	STAT_STOP(GLO_PHASE_WRITE, start);
+	return 1;
 }
 
 // GLO FREE
 
+// Frees what mesh holds, its children and its siblings, but not mesh itself
 void glo_free_mesh(GLO_MESH *mesh) {
-	if(mesh->num_movekeys) free(mesh->movekeys);
-	if(mesh->num_scalekeys) free(mesh->scalekeys);
-	if(mesh->num_rotatekeys) free(mesh->rotatekeys);
-	if(mesh->num_vertices) free(mesh->vertices);
-	if(mesh->num_faces) free(mesh->faces);
-	if(mesh->num_sprites) free(mesh->sprites);
-	if(mesh->has_child) glo_free_mesh(mesh->child);
-	if(mesh->has_next) glo_free_mesh(mesh->next);
+	GLO_MESH *first = mesh;
+	while(mesh) {
+		if(mesh->num_movekeys) free(mesh->movekeys);
+		if(mesh->num_scalekeys) free(mesh->scalekeys);
+		if(mesh->num_rotatekeys) free(mesh->rotatekeys);
+		if(mesh->num_vertices) free(mesh->vertices);
+		if(mesh->num_faces) free(mesh->faces);
+		if(mesh->num_sprites) free(mesh->sprites);
+		if(mesh->has_child) {
+			glo_free_mesh(mesh->child);
+			free(mesh->child);
+		}
+		GLO_MESH *next = mesh->has_next ? mesh->next : NULL;
+		if(mesh != first) free(mesh);
+		mesh = next;
+	}
 }
 
 void glo_free(GLO_FILE *glo) {
@@ -721,5 +1741,354 @@ void glo_free(GLO_FILE *glo) {
 	free(glo);
 }
 
+// GLO VALIDATE (binary)
+
+// Walks a GLO image in memory without decoding or allocating. Structural
+// problems (counts that overrun the data, bad flags) stop the scan since
+// nothing after them can be trusted. Value problems are reported and the scan
+// continues. Returns the number of issues, with a line per issue written to
+// report until it is full. Warnings are things stock files do too, like anims
+// running past the keyframes. They're reported the same way but only counted
+// in warnings, which can be NULL.
+
+typedef struct {
+	const uint8_t	*data;
+	size_t			size;
+	size_t			pos;
+	char			*report;
+	size_t			report_len;
+	size_t			report_pos;
+	int				issues;
+	int				warnings;
+	int				depth;
+	int				has_keys;
+	int				key_min;
+	int				key_max;
+} GLO_VALIDATOR;
+
+static void _glo_vline(GLO_VALIDATOR *v, size_t at, const char *kind, const char *fmt, va_list args) {
+	if(v->report_pos + 1 >= v->report_len) return;
+	char *out = v->report + v->report_pos;
+	size_t left = v->report_len - v->report_pos;
+	int len = snprintf(out, left, "  @%06X: %s", (unsigned)at, kind);
+	if(len > 0 && (size_t)len < left) len += vsnprintf(out + len, left - len, fmt, args);
+	if(len < 0 || (size_t)len >= left) {
+		// Only whole lines go in the report, the rest are just counted
+		out[0] = 0;
+		v->report_pos = v->report_len;
+		return;
+	}
+	v->report_pos += len;
+}
+
+static void _glo_vissue(GLO_VALIDATOR *v, size_t at, const char *fmt, ...) {
+	v->issues++;
+	va_list args;
+	va_start(args, fmt);
+	_glo_vline(v, at, "", fmt, args);
+	va_end(args);
+}
+
+static void _glo_vwarn(GLO_VALIDATOR *v, size_t at, const char *fmt, ...) {
+	v->warnings++;
+	va_list args;
+	va_start(args, fmt);
+	_glo_vline(v, at, "warning: ", fmt, args);
+	va_end(args);
+}
+
+static uint16_t _glo_rd16(const uint8_t *p) { uint16_t x; memcpy(&x, p, 2); return x; }
+static int32_t _glo_rd32(const uint8_t *p) { int32_t x; memcpy(&x, p, 4); return x; }
+
+// NaN and inf both have an all-ones exponent.
+static int _glo_badfloat(const uint8_t *p) {
+	uint32_t bits;
+	memcpy(&bits, p, 4);
+	return (bits & 0x7F800000) == 0x7F800000;
+}
+
+static int _glo_vneed(GLO_VALIDATOR *v, size_t bytes, const char *what) {
+	if(bytes > v->size - v->pos) {
+		_glo_vissue(v, v->pos, "%s needs %u bytes, only %u left\n",
+				what, (unsigned)bytes, (unsigned)(v->size - v->pos));
+		return 0;
+	}
+	return 1;
+}
+
+static int _glo_vflag(GLO_VALIDATOR *v, const char *what, uint16_t *res) {
+	if(!_glo_vneed(v, sizeof(uint16_t), what)) return 0;
+	*res = _glo_rd16(v->data + v->pos);
+	if(*res > 1) {
+		_glo_vissue(v, v->pos, "%s flag is %d, expected 0 or 1\n", what, *res);
+		return 0;
+	}
+	v->pos += sizeof(uint16_t);
+	return 1;
+}
+
+static int _glo_validate_keys(GLO_VALIDATOR *v, const char *name,
+		const char *what, int nfloats) {
+	if(!_glo_vneed(v, sizeof(uint16_t), what)) return 0;
+	int count = _glo_rd16(v->data + v->pos);
+	v->pos += sizeof(uint16_t);
+	size_t keysize = sizeof(int) + nfloats * sizeof(float);
+	if(!_glo_vneed(v, count * keysize, what)) return 0;
+	for(int k = 0; k < count; k++) {
+		const uint8_t *key = v->data + v->pos;
+		int time = _glo_rd32(key);
+		if(k > 0 && time < _glo_rd32(key - keysize)) {
+			_glo_vissue(v, v->pos, "mesh '%.*s': %s %d time %d before previous\n",
+					OBJ_NAME_LEN, name, what, k, time);
+		}
+		for(int i = 0; i < nfloats; i++) {
+			if(_glo_badfloat(key + sizeof(int) + i * sizeof(float))) {
+				_glo_vissue(v, v->pos, "mesh '%.*s': %s %d is NaN/inf\n",
+						OBJ_NAME_LEN, name, what, k);
+				break;
+			}
+		}
+		if(!v->has_keys || time < v->key_min) v->key_min = time;
+		if(!v->has_keys || time > v->key_max) v->key_max = time;
+		v->has_keys = 1;
+		v->pos += keysize;
+	}
+	return 1;
+}
+
+static int _glo_validate_mesh(GLO_VALIDATOR *v) {
+	if(v->depth >= MAX_MESH_DEPTH) {
+		_glo_vissue(v, v->pos, "mesh nesting deeper than %d\n", MAX_MESH_DEPTH);
+		return 0;
+	}
+	// Siblings don't nest, so they're walked in a loop instead of recursing
+	for(;;) {
+		if(!_glo_vneed(v, OBJ_NAME_LEN, "mesh name")) return 0;
+		const char *name = (const char*)v->data + v->pos;
+		if(!memchr(name, 0, OBJ_NAME_LEN)) {
+			_glo_vissue(v, v->pos, "mesh '%.*s': name not terminated\n", OBJ_NAME_LEN, name);
+		}
+		v->pos += OBJ_NAME_LEN;
+		if(!_glo_validate_keys(v, name, "movekey", 3)) return 0;
+		if(!_glo_validate_keys(v, name, "scalekey", 3)) return 0;
+		if(!_glo_validate_keys(v, name, "rotatekey", 4)) return 0;
+
+		if(!_glo_vneed(v, sizeof(uint16_t), "vertex count")) return 0;
+		int num_vertices = _glo_rd16(v->data + v->pos);
+		v->pos += sizeof(uint16_t);
+		if(!_glo_vneed(v, num_vertices * sizeof(GLO_VEC3), "vertices")) return 0;
+		for(int i = 0; i < num_vertices * 3; i++) {
+			if(_glo_badfloat(v->data + v->pos + i * sizeof(float))) {
+				_glo_vissue(v, v->pos, "mesh '%.*s': vertex %d is NaN/inf\n",
+						OBJ_NAME_LEN, name, i / 3);
+				i = i / 3 * 3 + 2;
+			}
+		}
+		v->pos += num_vertices * sizeof(GLO_VEC3);
+
+		if(!_glo_vneed(v, sizeof(uint16_t), "face count")) return 0;
+		int num_faces = _glo_rd16(v->data + v->pos);
+		v->pos += sizeof(uint16_t);
+		if(!_glo_vneed(v, num_faces * sizeof(GLO_DISK_FACE), "faces")) return 0;
+		for(int f = 0; f < num_faces; f++) {
+			const uint8_t *face = v->data + v->pos;
+			for(int i = 0; i < 3; i++) {
+				const uint8_t *vref = face + offsetof(GLO_DISK_FACE, vrefs) + i * sizeof(GLO_DISK_VREF);
+				int index = _glo_rd16(vref + offsetof(GLO_DISK_VREF, index));
+				if(index >= num_vertices) {
+					_glo_vissue(v, v->pos, "mesh '%.*s': face %d vref %d index %d >= %d vertices\n",
+							OBJ_NAME_LEN, name, f, i, index, num_vertices);
+				}
+				if(_glo_badfloat(vref + offsetof(GLO_DISK_VREF, uv)) ||
+						_glo_badfloat(vref + offsetof(GLO_DISK_VREF, uv) + sizeof(float))) {
+					_glo_vissue(v, v->pos, "mesh '%.*s': face %d vref %d uv is NaN/inf\n",
+							OBJ_NAME_LEN, name, f, i);
+				}
+			}
+			v->pos += sizeof(GLO_DISK_FACE);
+		}
+
+		if(!_glo_vneed(v, sizeof(uint16_t), "sprite count")) return 0;
+		int num_sprites = _glo_rd16(v->data + v->pos);
+		v->pos += sizeof(uint16_t);
+		if(!_glo_vneed(v, num_sprites * sizeof(GLO_DISK_SPRITE), "sprites")) return 0;
+		for(int s = 0; s < num_sprites; s++) {
+			const uint8_t *sprite = v->data + v->pos;
+			for(int i = 0; i < 5; i++) {
+				// pos and size are adjacent floats
+				if(_glo_badfloat(sprite + offsetof(GLO_DISK_SPRITE, pos) + i * sizeof(float))) {
+					_glo_vissue(v, v->pos, "mesh '%.*s': sprite %d is NaN/inf\n",
+							OBJ_NAME_LEN, name, s);
+					break;
+				}
+			}
+			v->pos += sizeof(GLO_DISK_SPRITE);
+		}
+
+		if(!_glo_vneed(v, 2 * sizeof(uint16_t), "mesh xlu/flags")) return 0;
+		v->pos += 2 * sizeof(uint16_t);
+		uint16_t has_child, has_next;
+		if(!_glo_vflag(v, "child", &has_child)) return 0;
+		v->depth++;
+		if(has_child && !_glo_validate_mesh(v)) return 0;
+		v->depth--;
+		if(!_glo_vflag(v, "next", &has_next)) return 0;
+		if(!has_next) return 1;
+	}
+}
+
+static int _glo_validate_object(GLO_VALIDATOR *v, int o) {
+	if(!_glo_vneed(v, sizeof(uint16_t), "anim count")) return 0;
+	int num_anims = _glo_rd16(v->data + v->pos);
+	v->pos += sizeof(uint16_t);
+	if(!_glo_vneed(v, num_anims * sizeof(GLO_DISK_ANIM), "anims")) return 0;
+	size_t anims = v->pos;
+	for(int a = 0; a < num_anims; a++) {
+		size_t at = v->pos;
+		const uint8_t *anim = v->data + at;
+		const char *name = (const char*)anim + offsetof(GLO_DISK_ANIM, name);
+		int start = _glo_rd32(anim + offsetof(GLO_DISK_ANIM, start));
+		int end = _glo_rd32(anim + offsetof(GLO_DISK_ANIM, end));
+		if(start > end) {
+			_glo_vissue(v, at, "object %d anim '%.*s': start %d after end %d\n",
+					o, ANIM_NAME_LEN, name, start, end);
+		}
+		if(_glo_badfloat(anim + offsetof(GLO_DISK_ANIM, speed))) {
+			_glo_vissue(v, at, "object %d anim '%.*s': speed is NaN/inf\n",
+					o, ANIM_NAME_LEN, name);
+		}
+		v->pos += sizeof(GLO_DISK_ANIM);
+	}
+	if(!_glo_vneed(v, sizeof(uint16_t), "mesh count")) return 0;
+	int num_meshes = _glo_rd16(v->data + v->pos);
+	v->pos += sizeof(uint16_t);
+	v->has_keys = 0;
+	for(int m = 0; m < num_meshes; m++) {
+		v->depth = 0;
+		if(!_glo_validate_mesh(v)) return 0;
+	}
+	// Anims come first in the file but the keyframes they play are in the meshes
+	for(int a = 0; a < num_anims && v->has_keys; a++) {
+		size_t at = anims + a * sizeof(GLO_DISK_ANIM);
+		const uint8_t *anim = v->data + at;
+		const char *name = (const char*)anim + offsetof(GLO_DISK_ANIM, name);
+		int start = _glo_rd32(anim + offsetof(GLO_DISK_ANIM, start));
+		int end = _glo_rd32(anim + offsetof(GLO_DISK_ANIM, end));
+		if(start <= end && (start < v->key_min || end > v->key_max)) {
+			_glo_vwarn(v, at, "object %d anim '%.*s': %d-%d outside keyframes %d-%d\n",
+					o, ANIM_NAME_LEN, name, start, end, v->key_min, v->key_max);
+		}
+	}
+	return 1;
+}
+
+int glo_validate(const void *data, size_t size, char *report, size_t report_len, int *warnings) {
+	GLO_VALIDATOR v = {0};
+	v.data = data;
+	v.size = size;
+	v.report = report;
+	v.report_len = report_len;
+	if(report_len) report[0] = 0;
+	if(warnings) *warnings = 0;
+	if(!_glo_vneed(&v, sizeof(GLO_DISK_HEADER) + sizeof(uint16_t), "header")) return v.issues;
+	if(memcmp(v.data, "GLO", 4) != 0) {
+		_glo_vissue(&v, 0, "invalid GLO header\n");
+		return v.issues;
+	}
+	if(_glo_rd16(v.data + offsetof(GLO_DISK_HEADER, version)) != GLO_VERSION_INT) {
+		_glo_vissue(&v, 0, "bad GLO version\n");
+		return v.issues;
+	}
+	v.pos = sizeof(GLO_DISK_HEADER);
+	int num_objects = _glo_rd16(v.data + v.pos);
+	v.pos += sizeof(uint16_t);
+	int o = 0;
+	while(o < num_objects && _glo_validate_object(&v, o)) o++;
+	if(o == num_objects && v.pos != v.size) {
+		_glo_vissue(&v, v.pos, "%u bytes of trailing data\n", (unsigned)(v.size - v.pos));
+	}
+	if(warnings) *warnings = v.warnings;
+	return v.issues;
+}
+
+// GLO SCAN (binary)
+
+// Finds objects and meshes in a GLO image by skipping over their counts,
+// without decoding anything, for tools that copy byte ranges between files.
+
+typedef struct {
+	const uint8_t	*data;
+	size_t			size;
+	size_t			pos;
+	GLO_SCAN		*scan;
+} GLO_SCANNER;
+
+static int _glo_skip(GLO_SCANNER *s, size_t bytes) {
+	if(bytes > s->size - s->pos) {
+		SETERR("Unexpected end of file at %X.\n", (unsigned)s->pos);
+		return 0;
+	}
+	s->pos += bytes;
+	return 1;
+}
+
+// Skips a count and that many records
+static int _glo_skip_array(GLO_SCANNER *s, size_t size) {
+	if(!_glo_skip(s, sizeof(uint16_t))) return 0;
+	return _glo_skip(s, _glo_rd16(s->data + s->pos - sizeof(uint16_t)) * size);
+}
+
+static int _glo_scan_mesh(GLO_SCANNER *s, int object, int depth) {
+	if(depth >= MAX_MESH_DEPTH) {
+		SETERR("Mesh nesting deeper than %d.\n", MAX_MESH_DEPTH);
+		return 0;
+	}
+	for(;;) {
+		GLO_MESH_SPAN span;
+		span.start = s->pos;
+		if(!_glo_skip(s, OBJ_NAME_LEN)) return 0;
+		if(!_glo_skip_array(s, sizeof(GLO_DISK_VKEY))) return 0;
+		if(!_glo_skip_array(s, sizeof(GLO_DISK_VKEY))) return 0;
+		if(!_glo_skip_array(s, sizeof(GLO_DISK_QKEY))) return 0;
+		if(!_glo_skip_array(s, sizeof(GLO_VEC3))) return 0;
+		if(!_glo_skip_array(s, sizeof(GLO_DISK_FACE))) return 0;
+		if(!_glo_skip_array(s, sizeof(GLO_DISK_SPRITE))) return 0;
+		if(!_glo_skip(s, 2 * sizeof(uint16_t))) return 0;
+		span.child = s->pos;
+		if(!_glo_skip(s, sizeof(uint16_t))) return 0;
+		if(_glo_rd16(s->data + span.child) && !_glo_scan_mesh(s, object, depth + 1)) return 0;
+		span.next = s->pos;
+		if(!_glo_skip(s, sizeof(uint16_t))) return 0;
+		if(s->scan->mesh) s->scan->mesh(s->scan->ctx, object, depth, &span);
+		if(!_glo_rd16(s->data + span.next)) return 1;
+	}
+}
+
+// Returns the number of objects, or -1 if the data is cut short
+int glo_scan(const void *data, size_t size, GLO_SCAN *scan) {
+	GLO_SCANNER s = { data, size, 0, scan };
+	if(size < sizeof(GLO_DISK_HEADER) || memcmp(data, "GLO", 4) != 0) {
+		SETERR("Invalid GLO header.\n");
+		return -1;
+	}
+	if(_glo_rd16(s.data + offsetof(GLO_DISK_HEADER, version)) != GLO_VERSION_INT) {
+		SETERR("Bad GLO version.\n");
+		return -1;
+	}
+	if(!_glo_skip(&s, sizeof(GLO_DISK_HEADER) + sizeof(uint16_t))) return -1;
+	int num_objects = _glo_rd16(s.data + sizeof(GLO_DISK_HEADER));
+	for(int o = 0; o < num_objects; o++) {
+		size_t start = s.pos;
+		if(!_glo_skip_array(&s, sizeof(GLO_DISK_ANIM))) return -1;
+		if(!_glo_skip(&s, sizeof(uint16_t))) return -1;
+		int num_meshes = _glo_rd16(s.data + s.pos - sizeof(uint16_t));
+		for(int m = 0; m < num_meshes; m++) {
+			if(!_glo_scan_mesh(&s, o, 0)) return -1;
+		}
+		if(scan->object) scan->object(scan->ctx, o, start, s.pos);
+	}
+	return num_objects;
+}
+
 #endif
 #endif
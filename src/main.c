@@ -1,8 +1,29 @@
+#include <math.h>
+#include <stdarg.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <sys/stat.h>
 #include <Windows.h>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+#ifdef GLO_STATS
+uint64_t ticks() {
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+}
+uint64_t ticks_per_sec() {
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return freq.QuadPart;
+}
+#define GLO_TICKS ticks
+#define GLO_TICKS_PER_SEC ticks_per_sec()
+#endif
 
 #define GLO_IMPLEMENTATION
 #include "./glo.h"
@@ -10,6 +31,8 @@
 typedef uint8_t bool;
 enum { false, true };
 
+int exitcode = 0;
+
 void* slurp_file(const char *fn, size_t *size) {
 	FILE *f = fopen(fn, "rb");
 	if (!f) {
@@ -35,25 +58,169 @@ void* slurp_file(const char *fn, size_t *size) {
 	return data;
 }
 
-// test
+// file lists
 
-void do_test(int argc, char *argv[]) {
-	if(argc != 2) {
-		printf("USAGE: gloverModTools test <in>\n");
-		printf("  in: path to a GLO file.\n");
+typedef struct {
+	int		count;
+	int		cap;
+	char	**paths;
+} FILE_LIST;
+
+void file_list_add(FILE_LIST *list, const char *path) {
+	if(list->count == list->cap) {
+		list->cap = list->cap ? list->cap * 2 : 64;
+		list->paths = realloc(list->paths, list->cap * sizeof(char*));
+	}
+	list->paths[list->count++] = strdup(path);
+}
+
+bool has_ext(const char *path, const char *ext) {
+	size_t plen = strlen(path), elen = strlen(ext);
+	if(plen < elen) return false;
+	for(size_t i = 0; i < elen; i++) {
+		char c = path[plen - elen + i];
+		if(c >= 'A' && c <= 'Z') c += 'a' - 'A';
+		if(c != ext[i]) return false;
+	}
+	return true;
+}
+
+// Adds path if it's a file, or every file under it ending in ext if it's a directory
+void file_list_scan(FILE_LIST *list, const char *path, const char *ext) {
+	DWORD attr = GetFileAttributesA(path);
+	if(attr == INVALID_FILE_ATTRIBUTES || !(attr & FILE_ATTRIBUTE_DIRECTORY)) {
+		file_list_add(list, path);
 		return;
 	}
-	GLO_FILE *glo = glo_load(argv[1]);
-	if(!glo) {
-		printf("%s\n", glo_error());
-		scanf("\npress any key to end");
-		exit(1);
+	char spec[MAX_PATH];
+	snprintf(spec, MAX_PATH, "%s/*", path);
+	WIN32_FIND_DATAA fd;
+	HANDLE find = FindFirstFileA(spec, &fd);
+	if(find == INVALID_HANDLE_VALUE) return;
+	do {
+		if(strcmp(fd.cFileName, ".") == 0 || strcmp(fd.cFileName, "..") == 0) continue;
+		char sub[MAX_PATH];
+		snprintf(sub, MAX_PATH, "%s/%s", path, fd.cFileName);
+		if(fd.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+			file_list_scan(list, sub, ext);
+		} else if(has_ext(fd.cFileName, ext)) {
+			file_list_add(list, sub);
+		}
+	} while(FindNextFileA(find, &fd));
+	FindClose(find);
+}
+
+void file_list_free(FILE_LIST *list) {
+	for(int i = 0; i < list->count; i++) free(list->paths[i]);
+	free(list->paths);
+}
+
+// Reads a whole file into a buffer that's grown as needed and reused between calls
+long read_file(const char *fn, uint8_t **buf, size_t *cap) {
+	FILE *f = fopen(fn, "rb");
+	if(!f) return -1;
+	fseek(f, 0, SEEK_END);
+	long size = ftell(f);
+	fseek(f, 0, SEEK_SET);
+	if((size_t)size > *cap) {
+		*cap = size;
+		*buf = realloc(*buf, size);
 	}
-	glo_save(glo, "test.glo");
-	glo_free(glo);
+	if(fread(*buf, 1, size, f) != (size_t)size) size = -1;
+	fclose(f);
+	return size;
+}
+
+// Growing text buffer for reports of any length
+typedef struct {
+	char	*data;
+	size_t	len;
+	size_t	cap;
+} TEXT;
+
+void text_printf(TEXT *text, const char *fmt, ...) {
+	va_list args;
+	va_start(args, fmt);
+	int len = vsnprintf(NULL, 0, fmt, args);
+	va_end(args);
+	if(text->len + len + 1 > text->cap) {
+		text->cap = (text->len + len + 1) * 2;
+		text->data = realloc(text->data, text->cap);
+	}
+	va_start(args, fmt);
+	vsnprintf(text->data + text->len, len + 1, fmt, args);
+	va_end(args);
+	text->len += len;
+}
+
+// mtime only has second precision, size catches most edits within a second
+void file_stamp(const char *fn, time_t *mtime, long *size) {
+	struct stat st;
+	if(stat(fn, &st) != 0) memset(&st, 0, sizeof(st));
+	*mtime = st.st_mtime;
+	*size = st.st_size;
+}
+
+double seconds() {
+	LARGE_INTEGER now, freq;
+	QueryPerformanceCounter(&now);
+	QueryPerformanceFrequency(&freq);
+	return (double)now.QuadPart / freq.QuadPart;
+}
+
+// parallel
+
+#define MAX_WORKERS 64
+
+typedef void (*JOB_FN)(void *ctx, int index, int worker);
+
+typedef struct {
+	JOB_FN			fn;
+	void			*ctx;
+	int				count;
+	int				worker;
+	volatile LONG	*next;
+} JOB_POOL;
+
+DWORD WINAPI job_worker(LPVOID arg) {
+	JOB_POOL *pool = arg;
+	for(;;) {
+		int i = InterlockedIncrement(pool->next) - 1;
+		if(i >= pool->count) break;
+		pool->fn(pool->ctx, i, pool->worker);
+	}
+	return 0;
+}
+
+// Runs fn for every index in [0, count) across up to MAX_WORKERS threads.
+// worker is below MAX_WORKERS so jobs can keep per-thread scratch space.
+void parallel_for(int count, JOB_FN fn, void *ctx) {
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int workers = info.dwNumberOfProcessors;
+	if(workers > MAX_WORKERS) workers = MAX_WORKERS;
+	if(workers > count) workers = count;
+	if(workers <= 1) {
+		for(int i = 0; i < count; i++) fn(ctx, i, 0);
+		return;
+	}
+	volatile LONG next = 0;
+	JOB_POOL pools[MAX_WORKERS];
+	HANDLE threads[MAX_WORKERS];
+	for(int w = 0; w < workers; w++) {
+		pools[w] = (JOB_POOL){ fn, ctx, count, w, &next };
+		threads[w] = CreateThread(NULL, 0, job_worker, &pools[w], 0, NULL);
+	}
+	WaitForMultipleObjects(workers, threads, TRUE, INFINITE);
+	for(int w = 0; w < workers; w++) CloseHandle(threads[w]);
+}
+
+// test
+
+bool compare_files(const char *fn1, const char *fn2) {
 	size_t size1, size2;
-	uint32_t *data1 = slurp_file(argv[1], &size1);
-	uint32_t *data2 = slurp_file("test.glo", &size2);
+	uint32_t *data1 = slurp_file(fn1, &size1);
+	uint32_t *data2 = slurp_file(fn2, &size2);
 	bool badsize = false;
 	if(size1 != size2) {
 		printf("FAIL - Sizes don't match!\n");
@@ -70,7 +237,7 @@ void do_test(int argc, char *argv[]) {
 			printf("  %08X vs %08X\n", data1[i], data2[i]);
 			free(data1);
 			free(data2);
-			return;
+			return false;
 		}
 	}
 	if(badsize) {
@@ -80,6 +247,35 @@ void do_test(int argc, char *argv[]) {
 	}
 	free(data1);
 	free(data2);
+	return !badsize;
+}
+
+void do_test(int argc, char *argv[]) {
+	if(argc != 2 && argc != 3) {
+		printf("USAGE: gloverModTools test <in> [txt]\n");
+		printf("  in:  path to a GLO file.\n");
+		printf("  txt: also round trip through exact text format.\n");
+		return;
+	}
+	GLO_FILE *glo = glo_load(argv[1]);
+	if(!glo) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	if(argc == 3) {
+		glo_save_txt(glo, "test.txt", GLO_TXT_EXACT);
+		glo_free(glo);
+		glo = glo_load_txt("test.txt");
+		if(!glo) {
+			printf("%s\n", glo_error());
+			scanf("\npress any key to end");
+			exit(1);
+		}
+	}
+	glo_save(glo, "test.glo");
+	glo_free(glo);
+	compare_files(argv[1], "test.glo");
 }
 
 // texswap
@@ -99,6 +295,14 @@ void texswap_mesh(GLO_MESH *mesh, char *from, char *to) {
 	if(mesh->has_next) texswap_mesh(mesh->next, from, to);
 }
 
+void texswap_glo(GLO_FILE *glo, char *from, char *to) {
+	for(int o = 0; o < glo->num_objects; o++) {
+		for(int m = 0; m < glo->objects[o].num_meshes; m++) {
+			texswap_mesh(&glo->objects[o].meshes[m], from, to);
+		}
+	}
+}
+
 void do_texswap(int argc, char *argv[]) {
 	if(argc != 4 && argc != 5) {
 		printf("USAGE: gloverModTools texswap <from> <to> <in> [out]\n");
@@ -114,11 +318,7 @@ void do_texswap(int argc, char *argv[]) {
 		scanf("\npress any key to end");
 		exit(1);
 	}
-	for(int o = 0; o < glo->num_objects; o++) {
-		for(int m = 0; m < glo->objects[o].num_meshes; m++) {
-			texswap_mesh(&glo->objects[o].meshes[m], argv[1], argv[2]);
-		}
-	}
+	texswap_glo(glo, argv[1], argv[2]);
 	glo_save(glo, argc == 5 ? argv[4] : argv[3]);
 	glo_free(glo);
 }
@@ -186,40 +386,276 @@ void do_texwrap(int argc, char *argv[]) {
 
 // meshdel
 
-void do_meshdel(int argc, char *argv[]) {
-	if(argc != 3 && argc != 4) {
-		printf("USAGE: gloverModTools meshdel <meshname> <in> [out]\n");
-		return;
-	}
-	GLO_FILE *glo = glo_load(argv[2]);
-	if(!glo) {
-		printf("%s\n", glo_error());
-		scanf("\npress any key to end");
-		exit(1);
-	}
+int meshdel_glo(GLO_FILE *glo, const char *name) {
+	int deleted = 0;
 	for(int o = 0; o < glo->num_objects; o++) {
 		GLO_OBJECT *obj = &glo->objects[o];
 		for(int m = 0; m < obj->num_meshes; m++) {
 			GLO_MESH *mesh = &obj->meshes[m];
-			if(strncmp(mesh->name, argv[1], OBJ_NAME_LEN) == 0) {
+			if(strncmp(mesh->name, name, OBJ_NAME_LEN) == 0) {
 				glo_free_mesh(mesh);
 				obj->num_meshes--;
 				for(int d = m; d < obj->num_meshes; d++) {
 					obj->meshes[d] = obj->meshes[d+1];
 				}
 				m--;
+				deleted++;
 			}
 		}
 	}
+	return deleted;
+}
+
+void do_meshdel(int argc, char *argv[]) {
+	if(argc != 3 && argc != 4) {
+		printf("USAGE: gloverModTools meshdel <meshname> <in> [out]\n");
+		return;
+	}
+	GLO_FILE *glo = glo_load(argv[2]);
+	if(!glo) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	meshdel_glo(glo, argv[1]);
 	glo_save(glo, argc == 4 ? argv[3] : argv[2]);
 	glo_free(glo);
 }
 
+// validate
+
+#define REPORT_LEN 1024
+
+typedef struct {
+	long	size;
+	int		issues;
+	int		warnings;
+	char	report[REPORT_LEN];
+} VALIDATE_RESULT;
+
+typedef struct {
+	FILE_LIST		files;
+	VALIDATE_RESULT	*results;
+	uint8_t			*bufs[MAX_WORKERS];
+	size_t			caps[MAX_WORKERS];
+} VALIDATE_JOB;
+
+void validate_file(void *ctx, int index, int worker) {
+	VALIDATE_JOB *job = ctx;
+	VALIDATE_RESULT *res = &job->results[index];
+	res->size = read_file(job->files.paths[index], &job->bufs[worker], &job->caps[worker]);
+	if(res->size < 0) {
+		res->issues = 1;
+		snprintf(res->report, REPORT_LEN, "  failed to read file\n");
+		return;
+	}
+	res->issues = glo_validate(job->bufs[worker], res->size, res->report, REPORT_LEN, &res->warnings);
+}
+
+void do_validate(int argc, char *argv[]) {
+	if(argc < 2) {
+		printf("USAGE: gloverModTools validate <in>...\n");
+		printf("  in: GLO files or directories to search for them\n");
+		return;
+	}
+	VALIDATE_JOB job = {0};
+	for(int i = 1; i < argc; i++) file_list_scan(&job.files, argv[i], ".glo");
+	job.results = calloc(job.files.count, sizeof(VALIDATE_RESULT));
+	double start = seconds();
+	parallel_for(job.files.count, validate_file, &job);
+	double elapsed = seconds() - start;
+	int bad = 0;
+	double total = 0;
+	for(int i = 0; i < job.files.count; i++) {
+		VALIDATE_RESULT *res = &job.results[i];
+		if(res->size > 0) total += res->size;
+		if(!res->issues && !res->warnings) continue;
+		if(res->issues) bad++;
+		printf("%s: %d issue%s", job.files.paths[i], res->issues, res->issues == 1 ? "" : "s");
+		if(res->warnings) printf(", %d warning%s", res->warnings, res->warnings == 1 ? "" : "s");
+		printf("\n%s", res->report);
+	}
+	printf("%d of %d files OK, %.1f MB in %.3fs\n", job.files.count - bad,
+			job.files.count, total / (1024 * 1024), elapsed);
+	if(bad) exitcode = 1;
+	for(int w = 0; w < MAX_WORKERS; w++) free(job.bufs[w]);
+	free(job.results);
+	file_list_free(&job.files);
+}
+
+// merge
+
+typedef struct {
+	int		want;
+	int		count;
+	size_t	start;
+	size_t	end;
+} MERGE_JOB;
+
+// Objects are stored back to back, so the ones kept are always one range
+void merge_object(void *ctx, int object, size_t start, size_t end) {
+	MERGE_JOB *job = ctx;
+	if(job->want >= 0 && object != job->want) return;
+	if(!job->count) job->start = start;
+	job->end = end;
+	job->count++;
+}
+
+void do_merge(int argc, char *argv[]) {
+	if(argc < 3) {
+		printf("USAGE: gloverModTools merge <out> <in>[#object]...\n");
+		printf("  out:    Output GLO file\n");
+		printf("  in:     GLO files to copy every object from, in order\n");
+		printf("  object: Copy only this object, counting from 0\n");
+		return;
+	}
+	FILE *f = fopen(argv[1], "wb");
+	if(!f) {
+		printf("Failed to open '%s'.\n", argv[1]);
+		return;
+	}
+	uint8_t *buf = NULL;
+	size_t cap = 0;
+	uint16_t total = 0;
+	for(int i = 2; i < argc; i++) {
+		char path[MAX_PATH];
+		snprintf(path, MAX_PATH, "%s", argv[i]);
+		MERGE_JOB job = { -1 };
+		char *hash = strrchr(path, '#');
+		if(hash) {
+			*hash = 0;
+			job.want = atoi(hash + 1);
+		}
+		long size = read_file(path, &buf, &cap);
+		GLO_SCAN scan = { &job, merge_object, NULL };
+		if(size < 0) {
+			printf("Failed to open '%s'.\n", path);
+		} else if(glo_scan(buf, size, &scan) < 0) {
+			printf("%s: %s", path, glo_error());
+		} else if(job.want >= 0 && !job.count) {
+			printf("%s: No object %d.\n", path, job.want);
+		} else if(total + job.count > 0xFFFF) {
+			printf("More than %d objects.\n", 0xFFFF);
+		} else {
+			if(i == 2) {
+				// Header from the first file, the count is filled in at the end
+				fwrite(buf, 1, sizeof(GLO_DISK_HEADER), f);
+				fwrite(&total, 1, sizeof(uint16_t), f);
+			}
+			fwrite(buf + job.start, 1, job.end - job.start, f);
+			total += job.count;
+			continue;
+		}
+		fclose(f);
+		remove(argv[1]);
+		free(buf);
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	fseek(f, sizeof(GLO_DISK_HEADER), SEEK_SET);
+	fwrite(&total, 1, sizeof(uint16_t), f);
+	fclose(f);
+	free(buf);
+	printf("Merged %d objects into %s\n", total, argv[1]);
+}
+
+// extract
+
+typedef struct {
+	const uint8_t	*data;
+	char			**names;
+	int				num_names;
+	GLO_MESH_SPAN	*spans;
+	int				count;
+	int				object;
+	size_t			anims;
+} EXTRACT_JOB;
+
+void extract_mesh(void *ctx, int object, int depth, const GLO_MESH_SPAN *span) {
+	EXTRACT_JOB *job = ctx;
+	for(int n = 0; n < job->num_names; n++) {
+		if(strncmp((const char*)job->data + span->start, job->names[n], OBJ_NAME_LEN) != 0) continue;
+		// A mesh already copied with an ancestor is left out. Meshes come
+		// after their children, so this one can also hold earlier matches.
+		int kept = 0;
+		for(int i = 0; i < job->count; i++) {
+			GLO_MESH_SPAN *other = &job->spans[i];
+			if(span->start >= other->start && span->next <= other->next) return;
+			if(other->start < span->start || other->next > span->next) job->spans[kept++] = *other;
+		}
+		job->count = kept;
+		if(!job->count) job->object = object;
+		job->spans = realloc(job->spans, (job->count + 1) * sizeof(GLO_MESH_SPAN));
+		job->spans[job->count++] = *span;
+		break;
+	}
+}
+
+// Anims start the object, keep the ones from the first extracted mesh's object
+void extract_object(void *ctx, int object, size_t start, size_t end) {
+	EXTRACT_JOB *job = ctx;
+	if(job->count && object == job->object && !job->anims) job->anims = start;
+}
+
+void do_extract(int argc, char *argv[]) {
+	if(argc < 4) {
+		printf("USAGE: gloverModTools extract <in> <out> <meshname>...\n");
+		printf("  in:       Input GLO file\n");
+		printf("  out:      Output GLO file with one object holding the meshes\n");
+		printf("  meshname: Meshes to copy along with their children\n");
+		return;
+	}
+	uint8_t *buf = NULL;
+	size_t cap = 0;
+	long size = read_file(argv[1], &buf, &cap);
+	if(size < 0) {
+		printf("Failed to open '%s'.\n", argv[1]);
+		return;
+	}
+	EXTRACT_JOB job = { buf, argv + 3, argc - 3 };
+	GLO_SCAN scan = { &job, extract_object, extract_mesh };
+	if(glo_scan(buf, size, &scan) < 0) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	if(!job.count) {
+		printf("No matching meshes in '%s'.\n", argv[1]);
+		free(buf);
+		return;
+	}
+	FILE *f = fopen(argv[2], "wb");
+	if(!f) {
+		printf("Failed to open '%s'.\n", argv[2]);
+		free(buf);
+		return;
+	}
+	uint16_t num_objects = 1, num_meshes = job.count, has_next = 0, num_anims;
+	memcpy(&num_anims, buf + job.anims, sizeof(uint16_t));
+	size_t anims = sizeof(uint16_t) + num_anims * sizeof(GLO_DISK_ANIM);
+	fwrite(buf, 1, sizeof(GLO_DISK_HEADER), f);
+	fwrite(&num_objects, 1, sizeof(uint16_t), f);
+	fwrite(buf + job.anims, 1, anims, f);
+	fwrite(&num_meshes, 1, sizeof(uint16_t), f);
+	for(int i = 0; i < job.count; i++) {
+		GLO_MESH_SPAN *span = &job.spans[i];
+		fwrite(buf + span->start, 1, span->next - span->start, f);
+		// Siblings stay behind
+		fwrite(&has_next, 1, sizeof(uint16_t), f);
+	}
+	fclose(f);
+	printf("Extracted %d meshes into %s\n", job.count, argv[2]);
+	free(job.spans);
+	free(buf);
+}
+
 // glo2txt
 
 void do_glo2txt(int argc, char *argv[]) {
-	if(argc != 3) {
-		printf("USAGE: gloverModTools glo2txt <in> <out>\n");
+	bool exact = argc == 4 && strcmp(argv[3], "--exact") == 0;
+	if(argc != 3 && !exact) {
+		printf("USAGE: gloverModTools glo2txt <in> <out> [--exact]\n");
+		printf("  --exact: write floats as raw bits so txt2glo restores them exactly\n");
 		return;
 	}
 	GLO_FILE *glo = glo_load(argv[1]);
@@ -228,7 +664,7 @@ void do_glo2txt(int argc, char *argv[]) {
 		scanf("\npress any key to end");
 		exit(1);
 	}
-	glo_save_txt(glo, argv[2]);
+	glo_save_txt(glo, argv[2], exact ? GLO_TXT_EXACT : 0);
 	glo_free(glo);
 }
 
@@ -249,29 +685,2034 @@ void do_txt2glo(int argc, char *argv[]) {
 	glo_free(glo);
 }
 
-int main(int argc, char *argv[]) {
-	if(argc == 1) {
-		printf("USAGE: gloverModTools <action> <stuff>\n");
-		printf("View readme for more info\nEnter just the action to see the stuff. Actions include:\n");
-		//printf("  test:    verify load+save results in an exact match\n");
-		//printf("  texswap: rename textures\n");
-		//printf("  texwrap: list all textures with >1 UV\n");
-		//printf("  meshdel: delete meshes matching a name\n");
-		printf("  glo2txt: convert glo object models to text format\n");
-		printf("  txt2glo: convert text file back into binary glo\n");
-		printf("Press enter to exit...\n");
-		getchar();
-		return 0;
+// glo2obj
+
+void do_glo2obj(int argc, char *argv[]) {
+	if(argc != 3) {
+		printf("USAGE: gloverModTools glo2obj <in> <out>\n");
+		return;
+	}
+	GLO_FILE *glo = glo_load(argv[1]);
+	if(!glo) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
 	}
+	glo_save_obj(glo, argv[2]);
+	glo_free(glo);
+}
 
-	//if(strcmp(argv[1], "test") == 0) do_test(argc-1, argv+1);
-	//if(strcmp(argv[1], "texswap") == 0) do_texswap(argc-1, argv+1);
-	//if(strcmp(argv[1], "texwrap") == 0) do_texwrap(argc-1, argv+1);
-	//if(strcmp(argv[1], "meshdel") == 0) do_meshdel(argc-1, argv+1);
-	if(strcmp(argv[1], "glo2txt") == 0) do_glo2txt(argc-1, argv+1);
-	if(strcmp(argv[1], "txt2glo") == 0) do_txt2glo(argc-1, argv+1);
+// obj2glo
 
-	printf("\ndone! Press Enter to exit...");
-	getchar(); 
-	return 0;
+void do_obj2glo(int argc, char *argv[]) {
+	if(argc != 3) {
+		printf("USAGE: gloverModTools obj2glo <in> <out>\n");
+		return;
+	}
+	GLO_FILE *glo = glo_load_obj(argv[1]);
+	if(!glo) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	glo_save(glo, argv[2]);
+	glo_free(glo);
+}
+
+// watch
+
+#define DEBOUNCE_MS 100
+
+typedef struct {
+	char	*path;
+	time_t	mtime;
+	long	size;
+} WATCH_FILE;
+
+typedef struct {
+	const char	*outdir;
+	WATCH_FILE	*files;
+	int			num_files;
+	int			*changed;
+	char		(*reports)[REPORT_LEN];
+} WATCH_JOB;
+
+void glo_path(char *out, const char *txt, const char *outdir) {
+	if(outdir) {
+		const char *name = strrchr(txt, '/');
+		const char *bslash = strrchr(txt, '\\');
+		if(!name || bslash > name) name = bslash;
+		snprintf(out, MAX_PATH, "%s/%s", outdir, name ? name + 1 : txt);
+	} else {
+		snprintf(out, MAX_PATH, "%s", txt);
+	}
+	size_t len = strlen(out);
+	if(len >= 4) strcpy(out + len - 4, ".glo");
+}
+
+void watch_convert(void *ctx, int index, int worker) {
+	WATCH_JOB *job = ctx;
+	WATCH_FILE *file = &job->files[job->changed[index]];
+	char *report = job->reports[index];
+	double start = seconds();
+	GLO_FILE *glo = glo_load_txt(file->path);
+	if(!glo) {
+		// Parse errors start with the line number
+		snprintf(report, REPORT_LEN, "%s:%s", file->path, glo_error());
+		return;
+	}
+	char out[MAX_PATH], tmp[MAX_PATH];
+	glo_path(out, file->path, job->outdir);
+	snprintf(tmp, MAX_PATH, "%s.tmp", out);
+	// Written to the side then renamed so the game never sees half a file
+	if(!glo_save(glo, tmp)) {
+		snprintf(report, REPORT_LEN, "%s", glo_error());
+	} else if(!MoveFileExA(tmp, out, MOVEFILE_REPLACE_EXISTING)) {
+		remove(tmp);
+		snprintf(report, REPORT_LEN, "Failed to replace '%s'.\n", out);
+	} else {
+		snprintf(report, REPORT_LEN, "%s -> %s (%.0fms)\n", file->path, out,
+				(seconds() - start) * 1000);
+	}
+	glo_free(glo);
+}
+
+// Rescans dir, listing files that are new or changed since the last scan
+int watch_scan(WATCH_JOB *job, const char *dir) {
+	FILE_LIST list = {0};
+	file_list_scan(&list, dir, ".txt");
+	job->changed = realloc(job->changed, (list.count + 1) * sizeof(int));
+	int count = 0;
+	for(int i = 0; i < list.count; i++) {
+		int f = 0;
+		for(; f < job->num_files; f++) {
+			if(strcmp(job->files[f].path, list.paths[i]) == 0) break;
+		}
+		WATCH_FILE *file = &job->files[f];
+		time_t mtime;
+		long size;
+		file_stamp(list.paths[i], &mtime, &size);
+		if(f == job->num_files) {
+			job->files = realloc(job->files, ++job->num_files * sizeof(WATCH_FILE));
+			file = &job->files[f];
+			file->path = strdup(list.paths[i]);
+			// Only convert new files when they're newer than their output
+			char out[MAX_PATH];
+			glo_path(out, file->path, job->outdir);
+			time_t outtime;
+			long outsize;
+			file_stamp(out, &outtime, &outsize);
+			file->mtime = outtime >= mtime ? mtime : 0;
+			file->size = outtime >= mtime ? size : 0;
+		}
+		if(file->mtime != mtime || file->size != size) {
+			file->mtime = mtime;
+			file->size = size;
+			job->changed[count++] = f;
+		}
+	}
+	file_list_free(&list);
+	return count;
+}
+
+typedef struct {
+	HANDLE		dir;
+	OVERLAPPED	overlapped;
+	DWORD		buffer[16384];
+} WATCH_DIR;
+
+bool watch_read(WATCH_DIR *w) {
+	ResetEvent(w->overlapped.hEvent);
+	return ReadDirectoryChangesW(w->dir, w->buffer, sizeof(w->buffer), TRUE,
+			FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE, NULL, &w->overlapped, NULL);
+}
+
+// Takes the finished read and starts the next one. Only text files count, so the
+// GLO files watch_convert writes into the tree don't trigger another scan.
+bool watch_changes(WATCH_DIR *w) {
+	DWORD bytes = 0;
+	GetOverlappedResult(w->dir, &w->overlapped, &bytes, FALSE);
+	// No bytes means the buffer overflowed and the names were lost
+	bool text = bytes == 0;
+	FILE_NOTIFY_INFORMATION *info = (FILE_NOTIFY_INFORMATION*)w->buffer;
+	while(bytes && !text) {
+		const WCHAR *name = info->FileName;
+		int len = info->FileNameLength / sizeof(WCHAR);
+		text = len >= 4;
+		for(int i = 0; i < 4 && text; i++) {
+			// Lower case for ASCII letters, leaves the dot alone
+			text = (name[len - 4 + i] | 0x20) == ".txt"[i];
+		}
+		if(!info->NextEntryOffset) break;
+		info = (FILE_NOTIFY_INFORMATION*)((uint8_t*)info + info->NextEntryOffset);
+	}
+	watch_read(w);
+	return text;
+}
+
+void do_watch(int argc, char *argv[]) {
+	if(argc != 2 && argc != 3) {
+		printf("USAGE: gloverModTools watch <dir> [outdir]\n");
+		printf("  dir:    folder of text models to convert whenever they're saved\n");
+		printf("  outdir: folder for the GLO files, or blank to write them next to the text\n");
+		return;
+	}
+	WATCH_JOB job = {0};
+	job.outdir = argc == 3 ? argv[2] : NULL;
+	WATCH_DIR *w = calloc(1, sizeof(WATCH_DIR));
+	w->dir = CreateFileA(argv[1], FILE_LIST_DIRECTORY,
+			FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, NULL, OPEN_EXISTING,
+			FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, NULL);
+	w->overlapped.hEvent = CreateEventA(NULL, TRUE, FALSE, NULL);
+	if(w->dir == INVALID_HANDLE_VALUE || !watch_read(w)) {
+		printf("Failed to watch '%s'.\n", argv[1]);
+		return;
+	}
+	printf("Watching %s, press Ctrl+C to stop\n", argv[1]);
+	for(;;) {
+		int count = watch_scan(&job, argv[1]);
+		if(count) {
+			job.reports = calloc(count, REPORT_LEN);
+			parallel_for(count, watch_convert, &job);
+			for(int i = 0; i < count; i++) printf("%s", job.reports[i]);
+			free(job.reports);
+			fflush(stdout);
+		}
+		do {
+			WaitForSingleObject(w->overlapped.hEvent, INFINITE);
+		} while(!watch_changes(w));
+		// Editors often write a file in several steps, wait for them to settle
+		while(WaitForSingleObject(w->overlapped.hEvent, DEBOUNCE_MS) != WAIT_TIMEOUT) {
+			watch_changes(w);
+		}
+	}
+}
+
+// server
+
+// Loads and saves .glo, .txt or .obj depending on the file extension
+GLO_FILE* load_any(const char *fn) {
+	if(has_ext(fn, ".txt")) return glo_load_txt(fn);
+	if(has_ext(fn, ".obj")) return glo_load_obj(fn);
+	return glo_load(fn);
+}
+
+bool save_any(GLO_FILE *glo, const char *fn, int flags) {
+	if(has_ext(fn, ".txt")) return glo_save_txt(glo, fn, flags);
+	if(has_ext(fn, ".obj")) return glo_save_obj(glo, fn);
+	return glo_save(glo, fn);
+}
+
+#define CACHE_SIZE 32
+
+// Parsed models kept between requests, dropped when the file changes on disk
+typedef struct {
+	char		path[MAX_PATH];
+	time_t		mtime;
+	long		size;
+	GLO_FILE	*glo;
+	unsigned	used;
+} CACHE_ENTRY;
+
+CACHE_ENTRY cache[CACHE_SIZE];
+unsigned cache_clock;
+
+void cache_evict(CACHE_ENTRY *entry) {
+	if(entry->glo) glo_free(entry->glo);
+	memset(entry, 0, sizeof(CACHE_ENTRY));
+}
+
+CACHE_ENTRY* cache_find(const char *fn) {
+	for(int i = 0; i < CACHE_SIZE; i++) {
+		if(cache[i].glo && strcmp(cache[i].path, fn) == 0) return &cache[i];
+	}
+	return NULL;
+}
+
+// Returns the cache entry for fn, loading it if it's missing or stale
+CACHE_ENTRY* cache_load(const char *fn) {
+	time_t mtime;
+	long size;
+	file_stamp(fn, &mtime, &size);
+	CACHE_ENTRY *entry = cache_find(fn);
+	if(entry && (entry->mtime != mtime || entry->size != size)) cache_evict(entry);
+	else if(entry) {
+		entry->used = ++cache_clock;
+		return entry;
+	}
+	GLO_FILE *glo = load_any(fn);
+	if(!glo) return NULL;
+	entry = &cache[0];
+	for(int i = 0; i < CACHE_SIZE; i++) {
+		if(!cache[i].glo) {
+			entry = &cache[i];
+			break;
+		}
+		if(cache[i].used < entry->used) entry = &cache[i];
+	}
+	cache_evict(entry);
+	strncpy(entry->path, fn, MAX_PATH-1);
+	entry->mtime = mtime;
+	entry->size = size;
+	entry->glo = glo;
+	entry->used = ++cache_clock;
+	return entry;
+}
+
+// Saves an entry's model to fn, which then becomes the entry's key. The old
+// path is no longer cached since the model may not match it anymore.
+bool cache_save(CACHE_ENTRY *entry, const char *fn, int flags) {
+	if(!save_any(entry->glo, fn, flags)) return false;
+	CACHE_ENTRY *other = cache_find(fn);
+	if(other && other != entry) cache_evict(other);
+	strncpy(entry->path, fn, MAX_PATH-1);
+	file_stamp(fn, &entry->mtime, &entry->size);
+	return true;
+}
+
+// Splits a request line into arguments, "quoted" ones may contain spaces
+int split_args(char *line, char *args[], int max) {
+	int count = 0;
+	for(char *pos = line; *pos && count < max;) {
+		while(*pos == ' ' || *pos == '\t' || *pos == '\r' || *pos == '\n') pos++;
+		if(!*pos) break;
+		char end = ' ';
+		if(*pos == '"') {
+			end = '"';
+			pos++;
+		}
+		args[count++] = pos;
+		while(*pos && *pos != end && (end == '"' || (*pos != '\t' && *pos != '\r' && *pos != '\n'))) pos++;
+		if(*pos) *pos++ = 0;
+	}
+	return count;
+}
+
+void query_mesh(GLO_MESH *mesh, int depth) {
+	printf("  %*smesh \"%.*s\" %d %d %d\n", depth * 2, "", OBJ_NAME_LEN, mesh->name,
+			mesh->num_vertices, mesh->num_faces, mesh->num_sprites);
+	if(mesh->has_child) query_mesh(mesh->child, depth + 1);
+	if(mesh->has_next) query_mesh(mesh->next, depth);
+}
+
+#define MAX_ARGS 16
+
+// Handles one request, printing any data lines then "ok" or "err <reason>"
+void serve(int argc, char *argv[]) {
+	CACHE_ENTRY *entry;
+	if(strcmp(argv[0], "load") == 0 && argc == 2) {
+		if(!(entry = cache_load(argv[1]))) goto err;
+		printf("ok %d\n", entry->glo->num_objects);
+	} else if(strcmp(argv[0], "save") == 0 && argc >= 3 && argc <= 4) {
+		if(!(entry = cache_load(argv[1]))) goto err;
+		int flags = argc == 4 && strcmp(argv[3], "--exact") == 0 ? GLO_TXT_EXACT : 0;
+		if(!cache_save(entry, argv[2], flags)) goto err;
+		printf("ok\n");
+	} else if(strcmp(argv[0], "convert") == 0 && argc >= 3 && argc <= 4) {
+		// Same as save but the source path stays cached
+		if(!(entry = cache_load(argv[1]))) goto err;
+		int flags = argc == 4 && strcmp(argv[3], "--exact") == 0 ? GLO_TXT_EXACT : 0;
+		if(!save_any(entry->glo, argv[2], flags)) goto err;
+		printf("ok\n");
+	} else if(strcmp(argv[0], "texswap") == 0 && argc >= 4 && argc <= 5) {
+		if(!(entry = cache_load(argv[3]))) goto err;
+		texswap_glo(entry->glo, argv[1], argv[2]);
+		if(!cache_save(entry, argc == 5 ? argv[4] : argv[3], 0)) goto evict;
+		printf("ok\n");
+	} else if(strcmp(argv[0], "meshdel") == 0 && argc >= 3 && argc <= 4) {
+		if(!(entry = cache_load(argv[2]))) goto err;
+		int deleted = meshdel_glo(entry->glo, argv[1]);
+		if(!cache_save(entry, argc == 4 ? argv[3] : argv[2], 0)) goto evict;
+		printf("ok %d\n", deleted);
+	} else if(strcmp(argv[0], "query") == 0 && argc == 2) {
+		if(!(entry = cache_load(argv[1]))) goto err;
+		GLO_FILE *glo = entry->glo;
+		for(int o = 0; o < glo->num_objects; o++) {
+			GLO_OBJECT *obj = &glo->objects[o];
+			printf("  object %d\n", o);
+			for(int a = 0; a < obj->num_anims; a++) {
+				GLO_ANIM *anim = &obj->anims[a];
+				printf("  anim \"%.*s\" %d %d\n", ANIM_NAME_LEN, anim->name, anim->start, anim->end);
+			}
+			for(int m = 0; m < obj->num_meshes; m++) query_mesh(&obj->meshes[m], 0);
+		}
+		printf("ok\n");
+	} else if(strcmp(argv[0], "evict") == 0 && argc <= 2) {
+		for(int i = 0; i < CACHE_SIZE; i++) {
+			if(argc == 1 || strcmp(cache[i].path, argv[1]) == 0) cache_evict(&cache[i]);
+		}
+		printf("ok\n");
+	} else {
+		printf("err Unknown request or wrong number of arguments\n");
+	}
+	return;
+evict:
+	// The edit is already applied to the cached model but not to any file
+	cache_evict(entry);
+err:
+	// Library errors end in a newline already
+	printf("err %s", glo_error());
+}
+
+void do_server(int argc, char *argv[]) {
+	if(argc != 1) {
+		printf("USAGE: gloverModTools server\n");
+		printf("  Reads one request per line from stdin, answering each with\n");
+		printf("  any data lines indented, then 'ok' or 'err <reason>'.\n");
+		printf("  load <in>                       parse a model into the cache\n");
+		printf("  save <in> <out> [--exact]       write a model, <out> becomes its key\n");
+		printf("  convert <in> <out> [--exact]    write a model in the format of <out>\n");
+		printf("  texswap <from> <to> <in> [out]  rename textures\n");
+		printf("  meshdel <meshname> <in> [out]   delete meshes matching a name\n");
+		printf("  query <in>                      list anims and meshes\n");
+		printf("  evict [in]                      drop one or all cached models\n");
+		printf("  quit\n");
+		return;
+	}
+	char line[4096];
+	while(fgets(line, sizeof(line), stdin)) {
+		char *args[MAX_ARGS];
+		int count = split_args(line, args, MAX_ARGS);
+		if(count == 0) continue;
+		if(strcmp(args[0], "quit") == 0) break;
+		errmsg[0] = 0;
+		serve(count, args);
+		fflush(stdout);
+	}
+	for(int i = 0; i < CACHE_SIZE; i++) cache_evict(&cache[i]);
+}
+
+// stats
+
+enum { STATS_OFF, STATS_TEXT, STATS_JSON };
+
+void print_stats(int mode) {
+#ifdef GLO_STATS
+	GLO_STATS_DATA *st = &glo_stats;
+	double freq = GLO_TICKS_PER_SEC;
+	if(mode == STATS_JSON) {
+		fprintf(stderr, "{\"seconds\": {");
+		for(int p = 0; p < GLO_NUM_PHASES; p++) {
+			fprintf(stderr, "%s\"%s\": %.6f", p ? ", " : "", glo_phase_names[p], st->ticks[p] / freq);
+		}
+		fprintf(stderr, "}, \"bytes_read\": %llu, \"bytes_written\": %llu, \"tokens\": %llu, "
+				"\"allocs\": %llu, \"alloc_bytes\": %llu, \"meshes\": %llu, \"faces\": %llu, "
+				"\"vertices\": %llu}\n",
+				(unsigned long long)st->bytes_read, (unsigned long long)st->bytes_written,
+				(unsigned long long)st->tokens, (unsigned long long)st->allocs,
+				(unsigned long long)st->alloc_bytes, (unsigned long long)st->meshes,
+				(unsigned long long)st->faces, (unsigned long long)st->vertices);
+		return;
+	}
+	for(int p = 0; p < GLO_NUM_PHASES; p++) {
+		fprintf(stderr, "%-10s %10.3fms\n", glo_phase_names[p], st->ticks[p] * 1000 / freq);
+	}
+	fprintf(stderr, "read       %10llu bytes\n", (unsigned long long)st->bytes_read);
+	fprintf(stderr, "written    %10llu bytes\n", (unsigned long long)st->bytes_written);
+	fprintf(stderr, "tokens     %10llu\n", (unsigned long long)st->tokens);
+	fprintf(stderr, "allocs     %10llu (%llu bytes)\n", (unsigned long long)st->allocs,
+			(unsigned long long)st->alloc_bytes);
+	fprintf(stderr, "meshes     %10llu\n", (unsigned long long)st->meshes);
+	fprintf(stderr, "faces      %10llu\n", (unsigned long long)st->faces);
+	fprintf(stderr, "vertices   %10llu\n", (unsigned long long)st->vertices);
+#else
+	fprintf(stderr, "Stats not available, rebuild with: make FLAGS=-DGLO_STATS\n");
+#endif
+}
+
+// transform
+
+// m is applied to positions, rot and scale are what it's made of so keyframes
+// and sprite sizes can follow. Rotations are exact with uniform scales only.
+typedef struct {
+	float		m[3][4];
+	GLO_QUAT	rot;
+	GLO_VEC3	scale;
+} XFORM;
+
+void xform_identity(XFORM *xf) {
+	memset(xf, 0, sizeof(XFORM));
+	for(int i = 0; i < 3; i++) {
+		xf->m[i][i] = 1;
+		xf->scale.v[i] = 1;
+	}
+	xf->rot.w = 1;
+}
+
+GLO_QUAT quat_mul(GLO_QUAT a, GLO_QUAT b) {
+	GLO_QUAT q;
+	q.x = a.w*b.x + a.x*b.w + a.y*b.z - a.z*b.y;
+	q.y = a.w*b.y - a.x*b.z + a.y*b.w + a.z*b.x;
+	q.z = a.w*b.z + a.x*b.y - a.y*b.x + a.z*b.w;
+	q.w = a.w*b.w - a.x*b.x - a.y*b.y - a.z*b.z;
+	return q;
+}
+
+// Applies op after everything already in xf
+void xform_then(XFORM *xf, float op[3][4]) {
+	float m[3][4];
+	for(int i = 0; i < 3; i++) {
+		for(int j = 0; j < 4; j++) {
+			m[i][j] = op[i][0]*xf->m[0][j] + op[i][1]*xf->m[1][j] + op[i][2]*xf->m[2][j];
+		}
+		m[i][3] += op[i][3];
+	}
+	memcpy(xf->m, m, sizeof(m));
+}
+
+bool parse_float(const char *str, float *out) {
+	char *end;
+	*out = strtof(str, &end);
+	return end != str && *end == 0;
+}
+
+// Parses "translate x y z", "scale s", "scale x y z" and "rotate x|y|z degrees"
+// in any number and order, each one applied after the ones before it.
+// Returns how many arguments were used, less than argc at a bad one.
+int xform_parse(XFORM *xf, int argc, char *argv[]) {
+	xform_identity(xf);
+	for(int i = 0; i < argc;) {
+		float op[3][4] = {{1, 0, 0, 0}, {0, 1, 0, 0}, {0, 0, 1, 0}};
+		float v[3];
+		if(strcmp(argv[i], "translate") == 0 && i + 3 < argc && parse_float(argv[i+1], &v[0])
+				&& parse_float(argv[i+2], &v[1]) && parse_float(argv[i+3], &v[2])) {
+			for(int a = 0; a < 3; a++) op[a][3] = v[a];
+			i += 4;
+		} else if(strcmp(argv[i], "scale") == 0 && i + 1 < argc && parse_float(argv[i+1], &v[0])) {
+			if(i + 3 < argc && parse_float(argv[i+2], &v[1]) && parse_float(argv[i+3], &v[2])) {
+				i += 4;
+			} else {
+				v[1] = v[2] = v[0];
+				i += 2;
+			}
+			for(int a = 0; a < 3; a++) {
+				op[a][a] = v[a];
+				xf->scale.v[a] *= fabsf(v[a]);
+			}
+		} else if(strcmp(argv[i], "rotate") == 0 && i + 2 < argc && strlen(argv[i+1]) == 1
+				&& argv[i+1][0] >= 'x' && argv[i+1][0] <= 'z' && parse_float(argv[i+2], &v[0])) {
+			int axis = argv[i+1][0] - 'x', a = (axis + 1) % 3, b = (axis + 2) % 3;
+			float rad = v[0] * 3.14159265f / 180;
+			op[a][a] = op[b][b] = cosf(rad);
+			op[a][b] = -sinf(rad);
+			op[b][a] = sinf(rad);
+			GLO_QUAT q = {{0, 0, 0, cosf(rad / 2)}};
+			q.v[axis] = sinf(rad / 2);
+			xf->rot = quat_mul(q, xf->rot);
+			i += 3;
+		} else {
+			return i;
+		}
+		xform_then(xf, op);
+	}
+	return argc;
+}
+
+void xform_point(const XFORM *xf, GLO_VEC3 *p, bool translate) {
+	GLO_VEC3 in = *p;
+	for(int i = 0; i < 3; i++) {
+		p->v[i] = xf->m[i][0]*in.x + xf->m[i][1]*in.y + xf->m[i][2]*in.z;
+		if(translate) p->v[i] += xf->m[i][3];
+	}
+}
+
+// Transforms a packed array of positions, four at a time where SSE is there
+void xform_points(const XFORM *xf, GLO_VEC3 *p, int count) {
+	int i = 0;
+#ifdef __SSE__
+	__m128 m[3][4];
+	for(int r = 0; r < 3; r++) {
+		for(int c = 0; c < 4; c++) m[r][c] = _mm_set1_ps(xf->m[r][c]);
+	}
+	for(; i + 4 <= count; i += 4) {
+		float *f = p[i].v;
+		// x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3 to one register per axis
+		__m128 a = _mm_loadu_ps(f), b = _mm_loadu_ps(f + 4), c = _mm_loadu_ps(f + 8);
+		__m128 t = _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 1, 3, 2));
+		__m128 u = _mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 0, 2, 1));
+		__m128 x = _mm_shuffle_ps(a, t, _MM_SHUFFLE(2, 0, 3, 0));
+		__m128 y = _mm_shuffle_ps(u, t, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128 z = _mm_shuffle_ps(u, c, _MM_SHUFFLE(3, 0, 3, 1));
+		__m128 o[3];
+		for(int r = 0; r < 3; r++) {
+			o[r] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[r][0], x), _mm_mul_ps(m[r][1], y)),
+					_mm_add_ps(_mm_mul_ps(m[r][2], z), m[r][3]));
+		}
+		// And back
+		__m128 lo = _mm_unpacklo_ps(o[0], o[1]), hi = _mm_unpackhi_ps(o[0], o[1]);
+		a = _mm_shuffle_ps(lo, _mm_shuffle_ps(o[2], lo, _MM_SHUFFLE(2, 2, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0));
+		b = _mm_shuffle_ps(_mm_shuffle_ps(lo, o[2], _MM_SHUFFLE(1, 1, 3, 3)), hi, _MM_SHUFFLE(1, 0, 2, 0));
+		c = _mm_shuffle_ps(_mm_shuffle_ps(o[2], hi, _MM_SHUFFLE(2, 2, 2, 2)),
+				_mm_shuffle_ps(hi, o[2], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+		_mm_storeu_ps(f, a);
+		_mm_storeu_ps(f + 4, b);
+		_mm_storeu_ps(f + 8, c);
+	}
+#endif
+	for(; i < count; i++) xform_point(xf, &p[i], true);
+}
+
+// Moves a mesh's own geometry, leaving its keyframes and children alone
+void xform_geometry(const XFORM *xf, GLO_MESH *mesh) {
+	xform_points(xf, mesh->vertices, mesh->num_vertices);
+	for(int s = 0; s < mesh->num_sprites; s++) {
+		xform_point(xf, &mesh->sprites[s].pos, true);
+		mesh->sprites[s].size.x *= xf->scale.x;
+		mesh->sprites[s].size.y *= xf->scale.y;
+	}
+}
+
+// Transforms one mesh as part of the whole model. Only the linear part goes
+// into vertices and keyframes, since those are relative to the parent. Root
+// meshes take the translation too, through a movekey added if there's none.
+void xform_mesh(const XFORM *xf, GLO_MESH *mesh, bool root) {
+	XFORM linear = *xf;
+	for(int i = 0; i < 3; i++) linear.m[i][3] = 0;
+	xform_geometry(&linear, mesh);
+	for(int k = 0; k < mesh->num_movekeys; k++) xform_point(xf, &mesh->movekeys[k].vert, false);
+	GLO_QUAT inv = {{-xf->rot.x, -xf->rot.y, -xf->rot.z, xf->rot.w}};
+	for(int k = 0; k < mesh->num_rotatekeys; k++) {
+		mesh->rotatekeys[k].quat = quat_mul(quat_mul(xf->rot, mesh->rotatekeys[k].quat), inv);
+	}
+	if(!root || (!xf->m[0][3] && !xf->m[1][3] && !xf->m[2][3])) return;
+	if(!mesh->num_movekeys) {
+		mesh->movekeys = calloc(1, sizeof(GLO_KEYF));
+		mesh->num_movekeys = 1;
+	}
+	for(int k = 0; k < mesh->num_movekeys; k++) {
+		for(int i = 0; i < 3; i++) mesh->movekeys[k].vert.v[i] += xf->m[i][3];
+	}
+}
+
+// Transforms the whole model, or with a name only the geometry of meshes
+// that have it. Returns how many meshes were changed.
+int xform_tree(const XFORM *xf, GLO_MESH *mesh, const char *name, bool root) {
+	int count = 0;
+	if(!name) {
+		xform_mesh(xf, mesh, root);
+		count++;
+	} else if(strncmp(mesh->name, name, OBJ_NAME_LEN) == 0) {
+		xform_geometry(xf, mesh);
+		count++;
+	}
+	if(mesh->has_child) count += xform_tree(xf, mesh->child, name, false);
+	if(mesh->has_next) count += xform_tree(xf, mesh->next, name, root);
+	return count;
+}
+
+void do_transform(int argc, char *argv[]) {
+	if(argc < 4) {
+		printf("USAGE: gloverModTools transform <in> <out> [-m <meshname>]... <op>...\n");
+		printf("  in, out:  .glo, .txt or .obj files\n");
+		printf("  -m:       only move the vertices and sprites of meshes with this name\n");
+		printf("  op:       translate <x> <y> <z>, scale <s>, scale <x> <y> <z> or\n");
+		printf("            rotate <x|y|z> <degrees>, applied in the order given\n");
+		return;
+	}
+	const char *names[MAX_ARGS];
+	int num_names = 0, i = 3;
+	for(; i + 1 < argc && strcmp(argv[i], "-m") == 0 && num_names < MAX_ARGS; i += 2) {
+		names[num_names++] = argv[i+1];
+	}
+	XFORM xf;
+	int used = xform_parse(&xf, argc - i, argv + i);
+	if(used < argc - i) {
+		printf("Bad transform at '%s'.\n", argv[i + used]);
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	GLO_FILE *glo = load_any(argv[1]);
+	if(!glo) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	int changed = 0;
+	for(int o = 0; o < glo->num_objects; o++) {
+		for(int m = 0; m < glo->objects[o].num_meshes; m++) {
+			GLO_MESH *mesh = &glo->objects[o].meshes[m];
+			if(!num_names) changed += xform_tree(&xf, mesh, NULL, true);
+			for(int n = 0; n < num_names; n++) changed += xform_tree(&xf, mesh, names[n], true);
+		}
+	}
+	if(!save_any(glo, argv[2], 0)) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	printf("Transformed %d meshes.\n", changed);
+	glo_free(glo);
+}
+
+// decimate
+
+// Plane quadrics, stored as the upper triangle of the 4x4 matrix:
+// aa ab ac ad bb bc bd cc cd dd
+typedef struct {
+	double	q[10];
+} QUADRIC;
+
+typedef struct {
+	float		cost;
+	int			from;
+	int			to;
+	unsigned	from_version;
+	unsigned	to_version;
+} COLLAPSE;
+
+typedef struct {
+	int	*faces;
+	int	count;
+	int	cap;
+} VERTEX_FACES;
+
+typedef struct {
+	GLO_MESH		*mesh;
+	QUADRIC			*quadrics;
+	VERTEX_FACES	*adj;
+	uint8_t			*locked;
+	uint8_t			*removed;
+	uint8_t			*dead;
+	uint8_t			*bad;
+	unsigned		*version;
+	int				*mark;
+	int				stamp;
+	COLLAPSE		*heap;
+	int				heap_count;
+	int				heap_cap;
+	int				faces_left;
+} DECIMATOR;
+
+void heap_push(DECIMATOR *d, COLLAPSE c) {
+	if(d->heap_count == d->heap_cap) {
+		d->heap_cap = d->heap_cap ? d->heap_cap * 2 : 1024;
+		d->heap = realloc(d->heap, d->heap_cap * sizeof(COLLAPSE));
+	}
+	int i = d->heap_count++;
+	while(i > 0 && d->heap[(i - 1) / 2].cost > c.cost) {
+		d->heap[i] = d->heap[(i - 1) / 2];
+		i = (i - 1) / 2;
+	}
+	d->heap[i] = c;
+}
+
+COLLAPSE heap_pop(DECIMATOR *d) {
+	COLLAPSE top = d->heap[0], last = d->heap[--d->heap_count];
+	int i = 0;
+	for(;;) {
+		int child = i * 2 + 1;
+		if(child >= d->heap_count) break;
+		if(child + 1 < d->heap_count && d->heap[child + 1].cost < d->heap[child].cost) child++;
+		if(d->heap[child].cost >= last.cost) break;
+		d->heap[i] = d->heap[child];
+		i = child;
+	}
+	if(d->heap_count) d->heap[i] = last;
+	return top;
+}
+
+void adj_add(VERTEX_FACES *adj, int face) {
+	if(adj->count == adj->cap) {
+		adj->cap = adj->cap ? adj->cap * 2 : 8;
+		adj->faces = realloc(adj->faces, adj->cap * sizeof(int));
+	}
+	adj->faces[adj->count++] = face;
+}
+
+void quadric_add_plane(QUADRIC *q, double a, double b, double c, double d, double weight) {
+	double p[4] = {a, b, c, d};
+	int k = 0;
+	for(int i = 0; i < 4; i++) {
+		for(int j = i; j < 4; j++) q->q[k++] += p[i] * p[j] * weight;
+	}
+}
+
+double quadric_error(const QUADRIC *a, const QUADRIC *b, const GLO_VEC3 *v) {
+	double q[10];
+	for(int i = 0; i < 10; i++) q[i] = a->q[i] + b->q[i];
+	double x = v->x, y = v->y, z = v->z;
+	return q[0]*x*x + 2*q[1]*x*y + 2*q[2]*x*z + 2*q[3]*x
+			+ q[4]*y*y + 2*q[5]*y*z + 2*q[6]*y
+			+ q[7]*z*z + 2*q[8]*z + q[9];
+}
+
+int face_corner(const GLO_FACE *face, int vertex) {
+	for(int c = 0; c < 3; c++) {
+		if(face->vrefs[c].index == vertex) return c;
+	}
+	return -1;
+}
+
+void face_normal(const GLO_VEC3 *a, const GLO_VEC3 *b, const GLO_VEC3 *c, double n[3]) {
+	double e1[3] = {b->x - a->x, b->y - a->y, b->z - a->z};
+	double e2[3] = {c->x - a->x, c->y - a->y, c->z - a->z};
+	n[0] = e1[1]*e2[2] - e1[2]*e2[1];
+	n[1] = e1[2]*e2[0] - e1[0]*e2[2];
+	n[2] = e1[0]*e2[1] - e1[1]*e2[0];
+}
+
+void push_collapse(DECIMATOR *d, int from, int to) {
+	if(d->locked[from]) return;
+	COLLAPSE c = {quadric_error(&d->quadrics[from], &d->quadrics[to], &d->mesh->vertices[to]),
+			from, to, d->version[from], d->version[to]};
+	heap_push(d, c);
+}
+
+// Queues collapses of v onto its neighbours, and theirs onto v with both set
+void push_around(DECIMATOR *d, int v, bool both) {
+	d->stamp++;
+	VERTEX_FACES *adj = &d->adj[v];
+	for(int i = 0; i < adj->count; i++) {
+		if(d->dead[adj->faces[i]]) continue;
+		GLO_FACE *face = &d->mesh->faces[adj->faces[i]];
+		for(int c = 0; c < 3; c++) {
+			int w = face->vrefs[c].index;
+			if(w == v || d->mark[w] == d->stamp) continue;
+			d->mark[w] = d->stamp;
+			if(both) push_collapse(d, w, v);
+			push_collapse(d, v, w);
+		}
+	}
+}
+
+// Moving u onto v must keep the surface manifold and not flip any face
+bool collapse_ok(DECIMATOR *d, int u, int v) {
+	GLO_MESH *mesh = d->mesh;
+	int shared = 0, common = 0;
+	d->stamp += 2;
+	VERTEX_FACES *adj = &d->adj[v];
+	for(int i = 0; i < adj->count; i++) {
+		if(d->dead[adj->faces[i]]) continue;
+		GLO_FACE *face = &mesh->faces[adj->faces[i]];
+		for(int c = 0; c < 3; c++) d->mark[face->vrefs[c].index] = d->stamp - 1;
+	}
+	adj = &d->adj[u];
+	for(int i = 0; i < adj->count; i++) {
+		if(d->dead[adj->faces[i]]) continue;
+		GLO_FACE *face = &mesh->faces[adj->faces[i]];
+		if(face_corner(face, v) >= 0) {
+			shared++;
+			continue;
+		}
+		for(int c = 0; c < 3; c++) {
+			int w = face->vrefs[c].index;
+			if(w != u && d->mark[w] == d->stamp - 1) {
+				d->mark[w] = d->stamp;
+				common++;
+			}
+		}
+		GLO_VEC3 *p[3];
+		for(int c = 0; c < 3; c++) p[c] = &mesh->vertices[face->vrefs[c].index];
+		double before[3], after[3];
+		face_normal(p[0], p[1], p[2], before);
+		p[face_corner(face, u)] = &mesh->vertices[v];
+		face_normal(p[0], p[1], p[2], after);
+		// Turning a face more than ~80 degrees is a flip or close to a sliver
+		double dot = before[0]*after[0] + before[1]*after[1] + before[2]*after[2];
+		double lens = (before[0]*before[0] + before[1]*before[1] + before[2]*before[2])
+				* (after[0]*after[0] + after[1]*after[1] + after[2]*after[2]);
+		if(dot <= 0 || dot * dot < 0.04 * lens) return false;
+	}
+	// Each shared face has one vertex next to both, any more would pinch
+	return shared > 0 && common <= shared;
+}
+
+void collapse(DECIMATOR *d, int u, int v) {
+	GLO_MESH *mesh = d->mesh;
+	VERTEX_FACES *adj = &d->adj[u];
+	// u's faces all use one UV for it, v's UV on that side comes from a shared face
+	GLO_VEC2 uv = {{0, 0}};
+	for(int i = 0; i < adj->count; i++) {
+		GLO_FACE *face = &mesh->faces[adj->faces[i]];
+		int c = face_corner(face, v);
+		if(!d->dead[adj->faces[i]] && c >= 0) {
+			uv = face->vrefs[c].uv;
+			break;
+		}
+	}
+	for(int i = 0; i < adj->count; i++) {
+		int f = adj->faces[i];
+		if(d->dead[f]) continue;
+		GLO_FACE *face = &mesh->faces[f];
+		if(face_corner(face, v) >= 0) {
+			d->dead[f] = 1;
+			d->faces_left--;
+			continue;
+		}
+		GLO_VREF *vref = &face->vrefs[face_corner(face, u)];
+		vref->index = v;
+		vref->uv = uv;
+		adj_add(&d->adj[v], f);
+	}
+	for(int i = 0; i < 10; i++) d->quadrics[v].q[i] += d->quadrics[u].q[i];
+	d->removed[u] = 1;
+	d->version[v]++;
+	push_around(d, v, true);
+}
+
+int edge_cmp(const void *a, const void *b) {
+	uint32_t x = *(uint32_t*)a, y = *(uint32_t*)b;
+	return x < y ? -1 : x > y;
+}
+
+// Vertices on open edges or where faces disagree on UV, texture or flags
+// stay where they are, along with anything on edges shared by 3+ faces
+void lock_vertices(DECIMATOR *d) {
+	GLO_MESH *mesh = d->mesh;
+	uint32_t *edges = malloc(mesh->num_faces * 3 * sizeof(uint32_t));
+	int count = 0;
+	for(int f = 0; f < mesh->num_faces; f++) {
+		if(d->bad[f]) continue;
+		for(int c = 0; c < 3; c++) {
+			uint32_t a = mesh->faces[f].vrefs[c].index, b = mesh->faces[f].vrefs[(c + 1) % 3].index;
+			edges[count++] = a < b ? (a << 16 | b) : (b << 16 | a);
+		}
+	}
+	qsort(edges, count, sizeof(uint32_t), edge_cmp);
+	for(int i = 0; i < count;) {
+		int j = i;
+		while(j < count && edges[j] == edges[i]) j++;
+		if(j - i != 2) d->locked[edges[i] >> 16] = d->locked[edges[i] & 0xFFFF] = 1;
+		i = j;
+	}
+	free(edges);
+	for(int v = 0; v < mesh->num_vertices; v++) {
+		VERTEX_FACES *adj = &d->adj[v];
+		if(!adj->count) continue;
+		GLO_FACE *first = &mesh->faces[adj->faces[0]];
+		GLO_VEC2 uv = first->vrefs[face_corner(first, v)].uv;
+		for(int i = 1; i < adj->count && !d->locked[v]; i++) {
+			GLO_FACE *face = &mesh->faces[adj->faces[i]];
+			GLO_VEC2 other = face->vrefs[face_corner(face, v)].uv;
+			if(memcmp(&uv, &other, sizeof(GLO_VEC2)) || face->flags != first->flags
+					|| strncmp(face->texture, first->texture, TEX_NAME_LEN)) {
+				d->locked[v] = 1;
+			}
+		}
+	}
+}
+
+// Collapses edges until target faces are left or nothing more can go.
+// Vertices no face uses are kept, as they may be used by the game.
+// Faces with a repeated or out of range index are kept as they are, and
+// their vertices never move. Returns how many such faces there were.
+int decimate_mesh(GLO_MESH *mesh, int target) {
+	int nv = mesh->num_vertices, nf = mesh->num_faces;
+	if(nf <= target) return 0;
+	DECIMATOR d = {mesh};
+	d.quadrics = calloc(nv, sizeof(QUADRIC));
+	d.adj = calloc(nv, sizeof(VERTEX_FACES));
+	d.locked = calloc(nv, 1);
+	d.removed = calloc(nv, 1);
+	d.dead = calloc(nf, 1);
+	d.bad = calloc(nf, 1);
+	d.version = calloc(nv, sizeof(unsigned));
+	d.mark = calloc(nv, sizeof(int));
+	d.faces_left = nf;
+	int bad = 0;
+	for(int f = 0; f < nf; f++) {
+		GLO_VREF *v = mesh->faces[f].vrefs;
+		if(v[0].index >= nv || v[1].index >= nv || v[2].index >= nv
+				|| v[0].index == v[1].index || v[1].index == v[2].index || v[0].index == v[2].index) {
+			d.bad[f] = 1;
+			bad++;
+		}
+	}
+	for(int f = 0; f < nf; f++) {
+		GLO_VREF *v = mesh->faces[f].vrefs;
+		if(d.bad[f]) {
+			for(int i = 0; i < 3; i++) {
+				if(v[i].index < nv) d.locked[v[i].index] = 1;
+			}
+			continue;
+		}
+		double n[3];
+		face_normal(&mesh->vertices[v[0].index], &mesh->vertices[v[1].index], &mesh->vertices[v[2].index], n);
+		double len = sqrt(n[0]*n[0] + n[1]*n[1] + n[2]*n[2]);
+		if(len > 0) {
+			// Weighted by area so small faces count for less
+			GLO_VEC3 *p = &mesh->vertices[v[0].index];
+			double a = n[0] / len, b = n[1] / len, c = n[2] / len;
+			double dist = -(a * p->x + b * p->y + c * p->z);
+			for(int i = 0; i < 3; i++) quadric_add_plane(&d.quadrics[v[i].index], a, b, c, dist, len / 2);
+		}
+		for(int i = 0; i < 3; i++) adj_add(&d.adj[v[i].index], f);
+	}
+	lock_vertices(&d);
+	for(int v = 0; v < nv; v++) {
+		if(!d.locked[v]) push_around(&d, v, false);
+	}
+	while(d.faces_left > target && d.heap_count) {
+		COLLAPSE c = heap_pop(&d);
+		if(d.removed[c.from] || d.removed[c.to]) continue;
+		if(d.version[c.from] != c.from_version || d.version[c.to] != c.to_version) continue;
+		if(collapse_ok(&d, c.from, c.to)) collapse(&d, c.from, c.to);
+	}
+	int *remap = d.mark;
+	int kept = 0;
+	for(int v = 0; v < nv; v++) {
+		if(d.removed[v]) continue;
+		mesh->vertices[kept] = mesh->vertices[v];
+		remap[v] = kept++;
+	}
+	int faces = 0;
+	for(int f = 0; f < nf; f++) {
+		if(d.dead[f]) continue;
+		GLO_FACE *face = &mesh->faces[faces++];
+		*face = mesh->faces[f];
+		for(int c = 0; c < 3; c++) {
+			if(face->vrefs[c].index < nv) face->vrefs[c].index = remap[face->vrefs[c].index];
+		}
+	}
+	mesh->num_vertices = kept;
+	mesh->num_faces = faces;
+	for(int v = 0; v < nv; v++) free(d.adj[v].faces);
+	free(d.quadrics);
+	free(d.adj);
+	free(d.locked);
+	free(d.removed);
+	free(d.dead);
+	free(d.bad);
+	free(d.version);
+	free(d.mark);
+	free(d.heap);
+	return bad;
+}
+
+int count_faces(GLO_MESH *mesh) {
+	int count = 0;
+	for(; mesh; mesh = mesh->has_next ? mesh->next : NULL) {
+		count += mesh->num_faces;
+		if(mesh->has_child) count += count_faces(mesh->child);
+	}
+	return count;
+}
+
+void decimate_tree(GLO_MESH *mesh, double ratio) {
+	for(; mesh; mesh = mesh->has_next ? mesh->next : NULL) {
+		int before = mesh->num_faces, vertices = mesh->num_vertices;
+		int bad = decimate_mesh(mesh, (int)(before * ratio + 0.5));
+		if(bad) {
+			printf("%.*s: left %d faces with bad vertex indices as they are\n", OBJ_NAME_LEN, mesh->name, bad);
+		}
+		if(before) {
+			printf("%.*s: %d -> %d faces, %d -> %d vertices\n", OBJ_NAME_LEN, mesh->name,
+					before, mesh->num_faces, vertices, mesh->num_vertices);
+		}
+		if(mesh->has_child) decimate_tree(mesh->child, ratio);
+	}
+}
+
+void do_decimate(int argc, char *argv[]) {
+	if(argc < 3) {
+		printf("USAGE: gloverModTools decimate <ratio|faces> <in> [out]\n");
+		printf("  ratio: fraction of faces to keep in every mesh, like 0.5\n");
+		printf("  faces: number of faces to keep in the whole model, spread over the meshes\n");
+		printf("  in, out: .glo, .txt or .obj files, out defaults to in\n");
+		return;
+	}
+	GLO_FILE *glo = load_any(argv[2]);
+	if(!glo) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	int total = 0;
+	for(int o = 0; o < glo->num_objects; o++) {
+		for(int m = 0; m < glo->objects[o].num_meshes; m++) total += count_faces(&glo->objects[o].meshes[m]);
+	}
+	double ratio = atof(argv[1]);
+	if(!strchr(argv[1], '.') && ratio >= 1) ratio = total ? ratio / total : 1;
+	if(ratio <= 0 || ratio > 1) {
+		printf("Bad ratio or face count '%s'.\n", argv[1]);
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	double start = seconds();
+	for(int o = 0; o < glo->num_objects; o++) {
+		for(int m = 0; m < glo->objects[o].num_meshes; m++) decimate_tree(&glo->objects[o].meshes[m], ratio);
+	}
+	printf("Decimated in %.3fs\n", seconds() - start);
+	if(!save_any(glo, argc > 3 ? argv[3] : argv[2], 0)) {
+		printf("%s\n", glo_error());
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	glo_free(glo);
+}
+
+// atlas
+
+// True if uv is outside 0 to 1 either way, so it relies on the texture repeating
+// and can't be moved into an atlas. texwrap only looks at values over 1.
+bool uv_wraps(const GLO_VEC2 *uv) {
+	return uv->x < 0.0f || uv->y < 0.0f || uv->x > 1.0f || uv->y > 1.0f;
+}
+
+typedef struct {
+	char	texture[TEX_NAME_LEN];
+	char	atlas[TEX_NAME_LEN];
+	float	x, y, w, h;
+} ATLAS_RECT;
+
+typedef struct {
+	ATLAS_RECT	*rects;
+	int			num_rects;
+	bool		dry_run;
+	FILE_LIST	files;
+	char		(*reports)[REPORT_LEN];
+} ATLAS_JOB;
+
+typedef struct {
+	int	faces;
+	int	wrapped;
+	int	sprites;
+} ATLAS_COUNTS;
+
+int atlas_cmp(const void *a, const void *b) {
+	return strncmp(((ATLAS_RECT*)a)->texture, ((ATLAS_RECT*)b)->texture, TEX_NAME_LEN);
+}
+
+ATLAS_RECT* atlas_find(ATLAS_JOB *job, const char *texture) {
+	ATLAS_RECT key;
+	memcpy(key.texture, texture, TEX_NAME_LEN);
+	return bsearch(&key, job->rects, job->num_rects, sizeof(ATLAS_RECT), atlas_cmp);
+}
+
+// Every texture a mesh uses is a separate draw, faces and sprites alike
+int count_draws(GLO_MESH *mesh) {
+	int draws = 0;
+	for(; mesh; mesh = mesh->has_next ? mesh->next : NULL) {
+		char (*seen)[TEX_NAME_LEN] = malloc((mesh->num_faces + mesh->num_sprites + 1) * TEX_NAME_LEN);
+		int count = 0;
+		for(int i = 0; i < mesh->num_faces + mesh->num_sprites; i++) {
+			char *tex = i < mesh->num_faces ? mesh->faces[i].texture : mesh->sprites[i - mesh->num_faces].texture;
+			int t = 0;
+			while(t < count && strncmp(seen[t], tex, TEX_NAME_LEN)) t++;
+			if(t == count) memcpy(seen[count++], tex, TEX_NAME_LEN);
+		}
+		free(seen);
+		draws += count;
+		if(mesh->has_child) draws += count_draws(mesh->child);
+	}
+	return draws;
+}
+
+void atlas_mesh(ATLAS_JOB *job, GLO_MESH *mesh, ATLAS_COUNTS *counts) {
+	for(; mesh; mesh = mesh->has_next ? mesh->next : NULL) {
+		for(int f = 0; f < mesh->num_faces; f++) {
+			GLO_FACE *face = &mesh->faces[f];
+			ATLAS_RECT *rect = atlas_find(job, face->texture);
+			if(!rect) continue;
+			if(uv_wraps(&face->vrefs[0].uv) || uv_wraps(&face->vrefs[1].uv) || uv_wraps(&face->vrefs[2].uv)) {
+				counts->wrapped++;
+				continue;
+			}
+			memcpy(face->texture, rect->atlas, TEX_NAME_LEN);
+			for(int v = 0; v < 3; v++) {
+				GLO_VEC2 *uv = &face->vrefs[v].uv;
+				uv->x = rect->x + uv->x * rect->w;
+				uv->y = rect->y + uv->y * rect->h;
+			}
+			counts->faces++;
+		}
+		// Sprites show their whole texture, there's no UV to move
+		for(int s = 0; s < mesh->num_sprites; s++) {
+			if(atlas_find(job, mesh->sprites[s].texture)) counts->sprites++;
+		}
+		if(mesh->has_child) atlas_mesh(job, mesh->child, counts);
+	}
+}
+
+void atlas_file(void *ctx, int index, int worker) {
+	ATLAS_JOB *job = ctx;
+	char *path = job->files.paths[index];
+	char *report = job->reports[index];
+	GLO_FILE *glo = glo_load(path);
+	if(!glo) {
+		snprintf(report, REPORT_LEN, "%s: %s", path, glo_error());
+		return;
+	}
+	ATLAS_COUNTS counts = {0};
+	int before = 0, after = 0;
+	for(int o = 0; o < glo->num_objects; o++) {
+		for(int m = 0; m < glo->objects[o].num_meshes; m++) {
+			GLO_MESH *mesh = &glo->objects[o].meshes[m];
+			before += count_draws(mesh);
+			atlas_mesh(job, mesh, &counts);
+			after += count_draws(mesh);
+		}
+	}
+	int len = snprintf(report, REPORT_LEN, "%s: %d -> %d draws, %d faces remapped", path, before, after, counts.faces);
+	if(counts.wrapped) len += snprintf(report + len, REPORT_LEN - len, ", %d faces wrap and were left", counts.wrapped);
+	if(counts.sprites) len += snprintf(report + len, REPORT_LEN - len, ", %d sprites can't use the atlas", counts.sprites);
+	snprintf(report + len, REPORT_LEN - len, "\n");
+	if(counts.faces && !job->dry_run && !glo_save(glo, path)) {
+		snprintf(report, REPORT_LEN, "%s: %s", path, glo_error());
+	}
+	glo_free(glo);
+}
+
+// Reads lines of "texture" "atlas" x y w h, ';' starts a comment
+bool atlas_load(ATLAS_JOB *job, const char *fn) {
+	FILE *f = fopen(fn, "r");
+	if(!f) {
+		printf("Failed to open '%s'.\n", fn);
+		return false;
+	}
+	char line[1024];
+	for(int ln = 1; fgets(line, sizeof(line), f); ln++) {
+		char *comment = strchr(line, ';');
+		if(comment) *comment = 0;
+		char *args[MAX_ARGS];
+		int count = split_args(line, args, MAX_ARGS);
+		if(!count) continue;
+		ATLAS_RECT rect = {{0}};
+		if(count != 6 || strlen(args[0]) > TEX_NAME_LEN || strlen(args[1]) > TEX_NAME_LEN
+				|| !parse_float(args[2], &rect.x) || !parse_float(args[3], &rect.y)
+				|| !parse_float(args[4], &rect.w) || !parse_float(args[5], &rect.h)) {
+			printf("%s:%d: Expected \"texture\" \"atlas\" x y w h.\n", fn, ln);
+			fclose(f);
+			return false;
+		}
+		strncpy(rect.texture, args[0], TEX_NAME_LEN);
+		strncpy(rect.atlas, args[1], TEX_NAME_LEN);
+		job->rects = realloc(job->rects, (job->num_rects + 1) * sizeof(ATLAS_RECT));
+		job->rects[job->num_rects++] = rect;
+	}
+	fclose(f);
+	qsort(job->rects, job->num_rects, sizeof(ATLAS_RECT), atlas_cmp);
+	return true;
+}
+
+void do_atlas(int argc, char *argv[]) {
+	if(argc < 3) {
+		printf("USAGE: gloverModTools atlas [-n] <layout> <in>...\n");
+		printf("  -n:     only report what would change\n");
+		printf("  layout: file with lines of \"texture\" \"atlas\" x y w h, the part of the\n");
+		printf("          atlas each texture was put in, from 0 to 1\n");
+		printf("  in:     files to edit in place, or directories to search for GLO files\n");
+		return;
+	}
+	ATLAS_JOB job = {0};
+	int i = 1;
+	if(strcmp(argv[i], "-n") == 0) {
+		job.dry_run = true;
+		i++;
+	}
+	if(i + 1 >= argc || !atlas_load(&job, argv[i])) {
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	for(i++; i < argc; i++) file_list_scan(&job.files, argv[i], ".glo");
+	job.reports = calloc(job.files.count, REPORT_LEN);
+	parallel_for(job.files.count, atlas_file, &job);
+	for(int f = 0; f < job.files.count; f++) printf("%s", job.reports[f]);
+	free(job.reports);
+	free(job.rects);
+	file_list_free(&job.files);
+}
+
+// pipeline
+
+enum { OP_TEXSWAP, OP_MESHDEL, OP_XLU, OP_FLAGS, OP_FACEFLAGS, OP_OPTIMIZE, OP_TRANSFORM };
+
+typedef struct {
+	int			type;
+	char		name[OBJ_NAME_LEN + 1];
+	char		to[TEX_NAME_LEN + 1];
+	uint16_t	value;
+	XFORM		xform;
+} PIPE_OP;
+
+typedef struct {
+	PIPE_OP		*ops;
+	int			num_ops;
+	FILE_LIST	files;
+	char		(*reports)[REPORT_LEN];
+} PIPE_JOB;
+
+typedef struct {
+	int	deleted;
+	int	welded;
+} PIPE_COUNTS;
+
+bool name_match(const char *pattern, const char *name, int len) {
+	return strcmp(pattern, "*") == 0 || strncmp(name, pattern, len) == 0;
+}
+
+int vertex_cmp(const void *a, const void *b) {
+	return memcmp(*(GLO_VEC3**)a, *(GLO_VEC3**)b, sizeof(GLO_VEC3));
+}
+
+// Merges vertices with identical positions. UVs and colors are per face, so
+// nothing is lost. Vertices no face uses are kept in case the game uses them.
+int optimize_mesh(GLO_MESH *mesh) {
+	int count = mesh->num_vertices;
+	if(count < 2) return 0;
+	GLO_VEC3 **sorted = malloc(count * sizeof(GLO_VEC3*));
+	int *remap = malloc(count * sizeof(int));
+	for(int i = 0; i < count; i++) sorted[i] = &mesh->vertices[i];
+	qsort(sorted, count, sizeof(GLO_VEC3*), vertex_cmp);
+	// Every vertex maps to the lowest index with the same position
+	for(int i = 0; i < count;) {
+		int j = i, first = sorted[i] - mesh->vertices;
+		for(; j < count && vertex_cmp(&sorted[i], &sorted[j]) == 0; j++) {
+			if(sorted[j] - mesh->vertices < first) first = sorted[j] - mesh->vertices;
+		}
+		for(; i < j; i++) remap[sorted[i] - mesh->vertices] = first;
+	}
+	int kept = 0;
+	for(int v = 0; v < count; v++) {
+		if(remap[v] == v) {
+			mesh->vertices[kept] = mesh->vertices[v];
+			remap[v] = kept++;
+		} else {
+			remap[v] = remap[remap[v]];
+		}
+	}
+	for(int f = 0; f < mesh->num_faces; f++) {
+		for(int v = 0; v < 3; v++) {
+			GLO_VREF *vref = &mesh->faces[f].vrefs[v];
+			if(vref->index < count) vref->index = remap[vref->index];
+		}
+	}
+	mesh->num_vertices = kept;
+	free(sorted);
+	free(remap);
+	return count - kept;
+}
+
+// Operations first to last-1 happen in one walk over the hierarchy
+void pipe_mesh(PIPE_JOB *job, int first, int last, GLO_MESH *mesh, bool root, PIPE_COUNTS *counts) {
+	for(int i = first; i < last; i++) {
+		PIPE_OP *op = &job->ops[i];
+		switch(op->type) {
+			case OP_TEXSWAP:
+			for(int f = 0; f < mesh->num_faces; f++) {
+				if(strncmp(mesh->faces[f].texture, op->name, TEX_NAME_LEN) == 0) {
+					strncpy(mesh->faces[f].texture, op->to, TEX_NAME_LEN);
+				}
+			}
+			for(int s = 0; s < mesh->num_sprites; s++) {
+				if(strncmp(mesh->sprites[s].texture, op->name, TEX_NAME_LEN) == 0) {
+					strncpy(mesh->sprites[s].texture, op->to, TEX_NAME_LEN);
+				}
+			}
+			break;
+			case OP_XLU:
+			if(name_match(op->name, mesh->name, OBJ_NAME_LEN)) mesh->xlu = op->value;
+			break;
+			case OP_FLAGS:
+			if(name_match(op->name, mesh->name, OBJ_NAME_LEN)) mesh->flags = op->value;
+			break;
+			case OP_FACEFLAGS:
+			for(int f = 0; f < mesh->num_faces; f++) {
+				if(name_match(op->name, mesh->faces[f].texture, TEX_NAME_LEN)) {
+					mesh->faces[f].flags = op->value;
+				}
+			}
+			break;
+			case OP_OPTIMIZE:
+			counts->welded += optimize_mesh(mesh);
+			break;
+			case OP_TRANSFORM:
+			if(strcmp(op->name, "*") == 0) xform_mesh(&op->xform, mesh, root);
+			else if(name_match(op->name, mesh->name, OBJ_NAME_LEN)) xform_geometry(&op->xform, mesh);
+			break;
+		}
+	}
+	if(mesh->has_child) pipe_mesh(job, first, last, mesh->child, false, counts);
+	if(mesh->has_next) pipe_mesh(job, first, last, mesh->next, root, counts);
+}
+
+void pipe_file(void *ctx, int index, int worker) {
+	PIPE_JOB *job = ctx;
+	char *path = job->files.paths[index];
+	char *report = job->reports[index];
+	GLO_FILE *glo = load_any(path);
+	if(!glo) {
+		snprintf(report, REPORT_LEN, "%s: %s", path, glo_error());
+		return;
+	}
+	PIPE_COUNTS counts = {0};
+	// Operations run in script order. The ones between deletes share a walk,
+	// since each only looks at one mesh at a time.
+	for(int first = 0, i = 0; i <= job->num_ops; i++) {
+		if(i < job->num_ops && job->ops[i].type != OP_MESHDEL) continue;
+		for(int o = 0; o < glo->num_objects && i > first; o++) {
+			for(int m = 0; m < glo->objects[o].num_meshes; m++) {
+				pipe_mesh(job, first, i, &glo->objects[o].meshes[m], true, &counts);
+			}
+		}
+		if(i < job->num_ops) counts.deleted += meshdel_glo(glo, job->ops[i].name);
+		first = i + 1;
+	}
+	if(!save_any(glo, path, 0)) {
+		snprintf(report, REPORT_LEN, "%s: %s", path, glo_error());
+	} else {
+		snprintf(report, REPORT_LEN, "%s: %d meshes deleted, %d vertices merged\n",
+				path, counts.deleted, counts.welded);
+	}
+	glo_free(glo);
+}
+
+// Reads a script with one operation per line, ';' starts a comment
+bool pipe_load(PIPE_JOB *job, const char *fn) {
+	FILE *f = fopen(fn, "r");
+	if(!f) {
+		printf("Failed to open '%s'.\n", fn);
+		return false;
+	}
+	char line[1024];
+	for(int ln = 1; fgets(line, sizeof(line), f); ln++) {
+		char *comment = strchr(line, ';');
+		if(comment) *comment = 0;
+		char *args[MAX_ARGS];
+		int count = split_args(line, args, MAX_ARGS);
+		if(!count) continue;
+		PIPE_OP op = {0};
+		unsigned value = 0;
+		if(strcmp(args[0], "texswap") == 0 && count == 3) {
+			op.type = OP_TEXSWAP;
+			strncpy(op.to, args[2], TEX_NAME_LEN);
+		} else if(strcmp(args[0], "meshdel") == 0 && count == 2) {
+			op.type = OP_MESHDEL;
+		} else if(strcmp(args[0], "xlu") == 0 && count == 3 && sscanf(args[2], "%X", &value)) {
+			op.type = OP_XLU;
+		} else if(strcmp(args[0], "flags") == 0 && count == 3 && sscanf(args[2], "%X", &value)) {
+			op.type = OP_FLAGS;
+		} else if(strcmp(args[0], "faceflags") == 0 && count == 3 && sscanf(args[2], "%X", &value)) {
+			op.type = OP_FACEFLAGS;
+		} else if(strcmp(args[0], "optimize") == 0 && count == 1) {
+			op.type = OP_OPTIMIZE;
+		} else if(strcmp(args[0], "transform") == 0 && count > 2) {
+			int used = xform_parse(&op.xform, count - 2, args + 2);
+			if(used < count - 2) {
+				printf("%s:%d: Bad transform at '%s'.\n", fn, ln, args[2 + used]);
+				fclose(f);
+				return false;
+			}
+			op.type = OP_TRANSFORM;
+		} else {
+			printf("%s:%d: Unknown operation or wrong number of arguments.\n", fn, ln);
+			fclose(f);
+			return false;
+		}
+		if(op.type == OP_TEXSWAP && (strlen(args[1]) > TEX_NAME_LEN || strlen(args[2]) > TEX_NAME_LEN)) {
+			printf("%s:%d: Texture name too long, max %d.\n", fn, ln, TEX_NAME_LEN);
+			fclose(f);
+			return false;
+		}
+		if(value > 0xFFFF) {
+			printf("%s:%d: Value too big, max FFFF.\n", fn, ln);
+			fclose(f);
+			return false;
+		}
+		if(count > 1) strncpy(op.name, args[1], OBJ_NAME_LEN);
+		op.value = value;
+		job->ops = realloc(job->ops, (job->num_ops + 1) * sizeof(PIPE_OP));
+		job->ops[job->num_ops++] = op;
+	}
+	fclose(f);
+	return true;
+}
+
+void do_pipeline(int argc, char *argv[]) {
+	if(argc < 3) {
+		printf("USAGE: gloverModTools pipeline <script> <in>...\n");
+		printf("  script: file with one operation per line:\n");
+		printf("    texswap <from> <to>       rename textures\n");
+		printf("    meshdel <meshname>        delete meshes matching a name\n");
+		printf("    xlu <meshname|*> <hex>    set mesh translucency\n");
+		printf("    flags <meshname|*> <hex>  set mesh flags\n");
+		printf("    faceflags <texture|*> <hex> set flags of faces using a texture\n");
+		printf("    optimize                  merge vertices at the same position\n");
+		printf("    transform <meshname|*> <op>... move meshes, or the whole model with *,\n");
+		printf("                              ops as in the transform command\n");
+		printf("  in:     files to edit in place, or directories to search for GLO files\n");
+		return;
+	}
+	PIPE_JOB job = {0};
+	if(!pipe_load(&job, argv[1])) {
+		scanf("\npress any key to end");
+		exit(1);
+	}
+	for(int i = 2; i < argc; i++) file_list_scan(&job.files, argv[i], ".glo");
+	job.reports = calloc(job.files.count, REPORT_LEN);
+	parallel_for(job.files.count, pipe_file, &job);
+	for(int i = 0; i < job.files.count; i++) printf("%s", job.reports[i]);
+	free(job.reports);
+	free(job.ops);
+	file_list_free(&job.files);
+}
+
+// report
+
+// Bump when the report text changes, so older .stats files are rewritten
+#define REPORT_VERSION 2
+
+typedef struct {
+	GLO_VEC3	min;
+	GLO_VEC3	max;
+	GLO_VEC3	center;
+	float		radius;
+} BOUNDS;
+
+typedef struct {
+	const char	*name;
+	int			depth;
+	int			faces;
+	int			vertices;
+	int			sprites;
+	int			degenerate;
+	BOUNDS		local;
+	BOUNDS		tree;
+	// The tree's sphere in the parent's space
+	GLO_VEC3	posed_center;
+	float		posed_radius;
+} MESH_STATS;
+
+typedef struct {
+	char	name[TEX_NAME_LEN];
+	int		faces;
+	int		sprites;
+} TEX_USE;
+
+typedef struct {
+	MESH_STATS	*meshes;
+	int			num_meshes;
+	int			cap_meshes;
+	TEX_USE		*textures;
+	int			num_textures;
+	int			cap_textures;
+} FILE_STATS;
+
+typedef struct {
+	FILE_LIST	files;
+	TEXT		*reports;
+	bool		*cached;
+	bool		force;
+	uint8_t		*bufs[MAX_WORKERS];
+	size_t		caps[MAX_WORKERS];
+} REPORT_JOB;
+
+uint64_t fnv1a(const uint8_t *data, size_t size) {
+	uint64_t hash = 0xCBF29CE484222325ULL;
+	for(size_t i = 0; i < size; i++) hash = (hash ^ data[i]) * 0x100000001B3ULL;
+	return hash;
+}
+
+void bounds_empty(BOUNDS *b) {
+	for(int a = 0; a < 3; a++) {
+		b->min.v[a] = INFINITY;
+		b->max.v[a] = -INFINITY;
+	}
+}
+
+bool bounds_valid(const BOUNDS *b) {
+	return b->min.x <= b->max.x;
+}
+
+void bounds_add(BOUNDS *b, const GLO_VEC3 *p, float extent) {
+	for(int a = 0; a < 3; a++) {
+		if(p->v[a] - extent < b->min.v[a]) b->min.v[a] = p->v[a] - extent;
+		if(p->v[a] + extent > b->max.v[a]) b->max.v[a] = p->v[a] + extent;
+	}
+}
+
+// Grows b to a packed array of positions, four at a time where SSE is there
+void bounds_points(BOUNDS *b, const GLO_VEC3 *p, int count) {
+	int i = 0;
+#ifdef __SSE__
+	if(count >= 4) {
+		// Lanes hold x0 y0 z0 x1 | y1 z1 x2 y2 | z2 x3 y3 z3, so float k of
+		// the twelve is always axis k % 3 and no shuffles are needed
+		__m128 lo[3], hi[3];
+		for(int r = 0; r < 3; r++) lo[r] = hi[r] = _mm_loadu_ps(p[0].v + r * 4);
+		for(; i + 4 <= count; i += 4) {
+			for(int r = 0; r < 3; r++) {
+				__m128 v = _mm_loadu_ps(p[i].v + r * 4);
+				lo[r] = _mm_min_ps(lo[r], v);
+				hi[r] = _mm_max_ps(hi[r], v);
+			}
+		}
+		float l[12], h[12];
+		for(int r = 0; r < 3; r++) {
+			_mm_storeu_ps(l + r * 4, lo[r]);
+			_mm_storeu_ps(h + r * 4, hi[r]);
+		}
+		for(int k = 0; k < 12; k++) {
+			if(l[k] < b->min.v[k % 3]) b->min.v[k % 3] = l[k];
+			if(h[k] > b->max.v[k % 3]) b->max.v[k % 3] = h[k];
+		}
+	}
+#endif
+	for(; i < count; i++) bounds_add(b, &p[i], 0);
+}
+
+float distance(const GLO_VEC3 *a, const GLO_VEC3 *b) {
+	float dx = a->x - b->x, dy = a->y - b->y, dz = a->z - b->z;
+	return sqrtf(dx*dx + dy*dy + dz*dz);
+}
+
+// Spheres are centered on the box, so they're not the tightest but they
+// always contain everything
+void bounds_center(BOUNDS *b) {
+	for(int a = 0; a < 3; a++) b->center.v[a] = (b->min.v[a] + b->max.v[a]) / 2;
+	b->radius = 0;
+}
+
+void bounds_sphere(BOUNDS *b, const GLO_VEC3 *center, float radius) {
+	float r = distance(&b->center, center) + radius;
+	if(r > b->radius) b->radius = r;
+}
+
+// Places a child in its parent using its first keyframes
+void bind_pose(const GLO_MESH *mesh, XFORM *xf) {
+	xform_identity(xf);
+	if(mesh->num_scalekeys) xf->scale = mesh->scalekeys[0].vert;
+	if(mesh->num_rotatekeys) xf->rot = mesh->rotatekeys[0].quat;
+	GLO_QUAT q = xf->rot;
+	float r[3][3] = {
+		{1 - 2*(q.y*q.y + q.z*q.z), 2*(q.x*q.y - q.z*q.w), 2*(q.x*q.z + q.y*q.w)},
+		{2*(q.x*q.y + q.z*q.w), 1 - 2*(q.x*q.x + q.z*q.z), 2*(q.y*q.z - q.x*q.w)},
+		{2*(q.x*q.z - q.y*q.w), 2*(q.y*q.z + q.x*q.w), 1 - 2*(q.x*q.x + q.y*q.y)},
+	};
+	for(int i = 0; i < 3; i++) {
+		for(int j = 0; j < 3; j++) xf->m[i][j] = r[i][j] * xf->scale.v[j];
+		xf->m[i][3] = mesh->num_movekeys ? mesh->movekeys[0].vert.v[i] : 0;
+	}
+}
+
+int count_degenerate(const GLO_MESH *mesh) {
+	int count = 0;
+	for(int f = 0; f < mesh->num_faces; f++) {
+		const GLO_VREF *v = mesh->faces[f].vrefs;
+		if(v[0].index >= mesh->num_vertices || v[1].index >= mesh->num_vertices
+				|| v[2].index >= mesh->num_vertices) {
+			count++;
+			continue;
+		}
+		const GLO_VEC3 *a = &mesh->vertices[v[0].index];
+		const GLO_VEC3 *b = &mesh->vertices[v[1].index];
+		const GLO_VEC3 *c = &mesh->vertices[v[2].index];
+		float e1[3] = {b->x - a->x, b->y - a->y, b->z - a->z};
+		float e2[3] = {c->x - a->x, c->y - a->y, c->z - a->z};
+		float n[3] = {e1[1]*e2[2] - e1[2]*e2[1], e1[2]*e2[0] - e1[0]*e2[2], e1[0]*e2[1] - e1[1]*e2[0]};
+		if(n[0]*n[0] + n[1]*n[1] + n[2]*n[2] < 1e-12f) count++;
+	}
+	return count;
+}
+
+void tex_use(FILE_STATS *st, const char *name, int faces, int sprites) {
+	int t = 0;
+	while(t < st->num_textures && strncmp(st->textures[t].name, name, TEX_NAME_LEN)) t++;
+	if(t == st->num_textures) {
+		if(st->num_textures == st->cap_textures) {
+			st->cap_textures = st->cap_textures ? st->cap_textures * 2 : 16;
+			st->textures = realloc(st->textures, st->cap_textures * sizeof(TEX_USE));
+		}
+		memset(&st->textures[t], 0, sizeof(TEX_USE));
+		memcpy(st->textures[t].name, name, TEX_NAME_LEN);
+		st->num_textures++;
+	}
+	st->textures[t].faces += faces;
+	st->textures[t].sprites += sprites;
+}
+
+// Fills in a mesh and its children in the order they're printed, and grows
+// tree by the mesh's hierarchy bounds in the parent's space
+void stats_mesh(FILE_STATS *st, const GLO_MESH *mesh, int depth, BOUNDS *tree) {
+	for(; mesh; mesh = mesh->has_next ? mesh->next : NULL) {
+		if(st->num_meshes == st->cap_meshes) {
+			st->cap_meshes = st->cap_meshes ? st->cap_meshes * 2 : 64;
+			st->meshes = realloc(st->meshes, st->cap_meshes * sizeof(MESH_STATS));
+		}
+		int index = st->num_meshes++;
+		MESH_STATS ms = {mesh->name, depth, mesh->num_faces, mesh->num_vertices,
+				mesh->num_sprites, count_degenerate(mesh)};
+		bounds_empty(&ms.local);
+		bounds_points(&ms.local, mesh->vertices, mesh->num_vertices);
+		for(int s = 0; s < mesh->num_sprites; s++) {
+			const GLO_SPRITE *spr = &mesh->sprites[s];
+			bounds_add(&ms.local, &spr->pos, fmaxf(fabsf(spr->size.x), fabsf(spr->size.y)) / 2);
+			tex_use(st, spr->texture, 0, 1);
+		}
+		for(int f = 0; f < mesh->num_faces; f++) tex_use(st, mesh->faces[f].texture, 1, 0);
+		if(bounds_valid(&ms.local)) {
+			bounds_center(&ms.local);
+			for(int v = 0; v < mesh->num_vertices; v++) bounds_sphere(&ms.local, &mesh->vertices[v], 0);
+			for(int s = 0; s < mesh->num_sprites; s++) {
+				const GLO_SPRITE *spr = &mesh->sprites[s];
+				bounds_sphere(&ms.local, &spr->pos, fmaxf(fabsf(spr->size.x), fabsf(spr->size.y)) / 2);
+			}
+		}
+		// Children come back as boxes and spheres in this mesh's space
+		BOUNDS children;
+		bounds_empty(&children);
+		int first_child = st->num_meshes;
+		if(mesh->has_child) stats_mesh(st, mesh->child, depth + 1, &children);
+		ms.tree = ms.local;
+		if(bounds_valid(&children)) {
+			if(bounds_valid(&ms.local)) {
+				bounds_add(&ms.tree, &children.min, 0);
+				bounds_add(&ms.tree, &children.max, 0);
+			} else {
+				ms.tree = children;
+			}
+			bounds_center(&ms.tree);
+			if(bounds_valid(&ms.local)) bounds_sphere(&ms.tree, &ms.local.center, ms.local.radius);
+			for(int c = first_child; c < st->num_meshes; c++) {
+				// Children with nothing in their tree were never posed
+				if(st->meshes[c].depth != depth + 1 || !bounds_valid(&st->meshes[c].tree)) continue;
+				bounds_sphere(&ms.tree, &st->meshes[c].posed_center, st->meshes[c].posed_radius);
+			}
+		}
+		st->meshes[index] = ms;
+		if(!tree || !bounds_valid(&ms.tree)) continue;
+		// Then this mesh's tree goes to the parent, through the bind pose
+		XFORM pose;
+		bind_pose(mesh, &pose);
+		for(int corner = 0; corner < 8; corner++) {
+			GLO_VEC3 p;
+			for(int a = 0; a < 3; a++) p.v[a] = (corner >> a) & 1 ? ms.tree.max.v[a] : ms.tree.min.v[a];
+			xform_point(&pose, &p, true);
+			bounds_add(tree, &p, 0);
+		}
+		MESH_STATS *posed = &st->meshes[index];
+		posed->posed_center = ms.tree.center;
+		xform_point(&pose, &posed->posed_center, true);
+		float scale = fmaxf(fabsf(pose.scale.x), fmaxf(fabsf(pose.scale.y), fabsf(pose.scale.z)));
+		posed->posed_radius = ms.tree.radius * scale;
+	}
+}
+
+void print_bounds(TEXT *out, int indent, const char *label, const BOUNDS *b) {
+	if(!bounds_valid(b)) {
+		text_printf(out, "%*s%s empty\n", indent, "", label);
+		return;
+	}
+	text_printf(out, "%*s%s (%g %g %g) to (%g %g %g), sphere (%g %g %g) r %g\n", indent, "", label,
+			b->min.x, b->min.y, b->min.z, b->max.x, b->max.y, b->max.z,
+			b->center.x, b->center.y, b->center.z, b->radius);
+}
+
+void report_glo(TEXT *out, const GLO_FILE *glo) {
+	FILE_STATS st = {0};
+	for(int o = 0; o < glo->num_objects; o++) {
+		text_printf(out, "  object %d\n", o);
+		int first = st.num_meshes;
+		for(int m = 0; m < glo->objects[o].num_meshes; m++) {
+			stats_mesh(&st, &glo->objects[o].meshes[m], 0, NULL);
+		}
+		for(int m = first; m < st.num_meshes; m++) {
+			MESH_STATS *ms = &st.meshes[m];
+			int indent = 4 + ms->depth * 2;
+			text_printf(out, "%*s%.*s: %d faces, %d vertices, %d sprites, %d degenerate\n", indent, "",
+					OBJ_NAME_LEN, ms->name, ms->faces, ms->vertices, ms->sprites, ms->degenerate);
+			print_bounds(out, indent + 2, "local", &ms->local);
+			print_bounds(out, indent + 2, "tree ", &ms->tree);
+		}
+	}
+	text_printf(out, "  textures\n");
+	for(int t = 0; t < st.num_textures; t++) {
+		text_printf(out, "    %.*s: %d faces, %d sprites\n", TEX_NAME_LEN, st.textures[t].name,
+				st.textures[t].faces, st.textures[t].sprites);
+	}
+	free(st.meshes);
+	free(st.textures);
+}
+
+// Reports are kept next to each file in <file>.stats, whose first line holds
+// the report version and the hash of the file they came from
+void report_file(void *ctx, int index, int worker) {
+	REPORT_JOB *job = ctx;
+	char *path = job->files.paths[index];
+	TEXT *out = &job->reports[index];
+	long size = read_file(path, &job->bufs[worker], &job->caps[worker]);
+	if(size < 0) {
+		text_printf(out, "  failed to read file\n");
+		return;
+	}
+	uint64_t hash = fnv1a(job->bufs[worker], size);
+	char header[64], line[64], sidecar[MAX_PATH + 8];
+	snprintf(header, sizeof(header), "; report %d fnv1a %08X%08X\n", REPORT_VERSION,
+			(unsigned)(hash >> 32), (unsigned)hash);
+	snprintf(sidecar, sizeof(sidecar), "%s.stats", path);
+	FILE *f = job->force ? NULL : fopen(sidecar, "rb");
+	if(f) {
+		if(fgets(line, sizeof(line), f) && strcmp(line, header) == 0) {
+			char buf[4096];
+			size_t n;
+			while((n = fread(buf, 1, sizeof(buf), f)) > 0) text_printf(out, "%.*s", (int)n, buf);
+			job->cached[index] = true;
+		}
+		fclose(f);
+		if(job->cached[index]) return;
+	}
+	GLO_FILE *glo = glo_load_mem(job->bufs[worker], size);
+	if(!glo) {
+		text_printf(out, "  %s", glo_error());
+		return;
+	}
+	report_glo(out, glo);
+	glo_free(glo);
+	// A read only install just doesn't get a cache
+	f = fopen(sidecar, "wb");
+	if(f) {
+		fputs(header, f);
+		fwrite(out->data, 1, out->len, f);
+		fclose(f);
+	}
+}
+
+void do_report(int argc, char *argv[]) {
+	if(argc < 2) {
+		printf("USAGE: gloverModTools report [-f] <in>...\n");
+		printf("  -f: ignore and rewrite cached reports\n");
+		printf("  in: GLO files or directories to search for them\n");
+		return;
+	}
+	REPORT_JOB job = {0};
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "-f") == 0) job.force = true;
+		else file_list_scan(&job.files, argv[i], ".glo");
+	}
+	job.reports = calloc(job.files.count, sizeof(TEXT));
+	job.cached = calloc(job.files.count, sizeof(bool));
+	double start = seconds();
+	parallel_for(job.files.count, report_file, &job);
+	double elapsed = seconds() - start;
+	int cached = 0;
+	for(int i = 0; i < job.files.count; i++) {
+		printf("%s\n%.*s", job.files.paths[i], (int)job.reports[i].len, job.reports[i].data);
+		cached += job.cached[i];
+		free(job.reports[i].data);
+	}
+	printf("%d files, %d from cache, in %.3fs\n", job.files.count, cached, elapsed);
+	for(int w = 0; w < MAX_WORKERS; w++) free(job.bufs[w]);
+	free(job.reports);
+	free(job.cached);
+	file_list_free(&job.files);
+}
+
+// dedup
+
+typedef struct {
+	uint64_t	hash;
+	size_t		size;
+	int			file;
+	int			object;
+	char		name[OBJ_NAME_LEN];
+} MESH_HASH;
+
+typedef struct {
+	MESH_HASH	*meshes;
+	int			count;
+	char		error[ERRMSG_LEN];
+} DEDUP_FILE;
+
+typedef struct {
+	FILE_LIST	files;
+	DEDUP_FILE	*results;
+	bool		ignore_names;
+	uint8_t		*bufs[MAX_WORKERS];
+	size_t		caps[MAX_WORKERS];
+} DEDUP_JOB;
+
+typedef struct {
+	DEDUP_JOB		*job;
+	const uint8_t	*data;
+	int				file;
+} DEDUP_SCAN;
+
+typedef struct {
+	MESH_HASH	*first;
+	int			count;
+	size_t		wasted;
+} DEDUP_GROUP;
+
+// A mesh's own data runs from its name to its has_child flag, children and
+// siblings are meshes of their own
+void dedup_mesh(void *ctx, int object, int depth, const GLO_MESH_SPAN *span) {
+	DEDUP_SCAN *scan = ctx;
+	DEDUP_FILE *res = &scan->job->results[scan->file];
+	size_t start = span->start + (scan->job->ignore_names ? OBJ_NAME_LEN : 0);
+	res->meshes = realloc(res->meshes, (res->count + 1) * sizeof(MESH_HASH));
+	MESH_HASH *mh = &res->meshes[res->count++];
+	mh->hash = fnv1a(scan->data + start, span->child - start);
+	mh->size = span->child - start;
+	mh->file = scan->file;
+	mh->object = object;
+	memcpy(mh->name, scan->data + span->start, OBJ_NAME_LEN);
+}
+
+void dedup_file(void *ctx, int index, int worker) {
+	DEDUP_JOB *job = ctx;
+	DEDUP_FILE *res = &job->results[index];
+	long size = read_file(job->files.paths[index], &job->bufs[worker], &job->caps[worker]);
+	if(size < 0) {
+		snprintf(res->error, ERRMSG_LEN, "Failed to read file.\n");
+		return;
+	}
+	DEDUP_SCAN scan = {job, job->bufs[worker], index};
+	GLO_SCAN cb = {&scan, NULL, dedup_mesh};
+	if(glo_scan(job->bufs[worker], size, &cb) < 0) snprintf(res->error, ERRMSG_LEN, "%s", glo_error());
+}
+
+int hash_cmp(const void *a, const void *b) {
+	const MESH_HASH *x = a, *y = b;
+	if(x->hash != y->hash) return x->hash < y->hash ? -1 : 1;
+	if(x->size != y->size) return x->size < y->size ? -1 : 1;
+	if(x->file != y->file) return x->file - y->file;
+	return x->object - y->object;
+}
+
+int group_cmp(const void *a, const void *b) {
+	const DEDUP_GROUP *x = a, *y = b;
+	if(x->wasted != y->wasted) return x->wasted > y->wasted ? -1 : 1;
+	return hash_cmp(x->first, y->first);
+}
+
+void do_dedup(int argc, char *argv[]) {
+	if(argc < 2) {
+		printf("USAGE: gloverModTools dedup [-i] <in>...\n");
+		printf("  -i: ignore mesh names, so renamed copies are found too\n");
+		printf("  in: GLO files or directories to search for them\n");
+		return;
+	}
+	DEDUP_JOB job = {0};
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "-i") == 0) job.ignore_names = true;
+		else file_list_scan(&job.files, argv[i], ".glo");
+	}
+	job.results = calloc(job.files.count, sizeof(DEDUP_FILE));
+	double start = seconds();
+	parallel_for(job.files.count, dedup_file, &job);
+	// Same hash and size is taken as same content, sorting puts copies together
+	int total = 0;
+	for(int f = 0; f < job.files.count; f++) total += job.results[f].count;
+	MESH_HASH *all = malloc((total + 1) * sizeof(MESH_HASH));
+	total = 0;
+	for(int f = 0; f < job.files.count; f++) {
+		DEDUP_FILE *res = &job.results[f];
+		if(res->error[0]) printf("%s: %s", job.files.paths[f], res->error);
+		if(res->count) memcpy(all + total, res->meshes, res->count * sizeof(MESH_HASH));
+		total += res->count;
+		free(res->meshes);
+	}
+	qsort(all, total, sizeof(MESH_HASH), hash_cmp);
+	DEDUP_GROUP *groups = malloc((total / 2 + 1) * sizeof(DEDUP_GROUP));
+	int num_groups = 0, copies = 0;
+	size_t bytes = 0, wasted = 0;
+	for(int i = 0; i < total;) {
+		int j = i;
+		while(j < total && all[j].hash == all[i].hash && all[j].size == all[i].size) j++;
+		for(int k = i; k < j; k++) bytes += all[k].size;
+		if(j - i > 1) {
+			DEDUP_GROUP *g = &groups[num_groups++];
+			g->first = &all[i];
+			g->count = j - i;
+			g->wasted = all[i].size * (j - i - 1);
+			copies += j - i - 1;
+			wasted += g->wasted;
+		}
+		i = j;
+	}
+	double elapsed = seconds() - start;
+	qsort(groups, num_groups, sizeof(DEDUP_GROUP), group_cmp);
+	for(int g = 0; g < num_groups; g++) {
+		MESH_HASH *first = groups[g].first;
+		printf("%08X%08X: %d copies of %u bytes, %u wasted\n", (unsigned)(first->hash >> 32),
+				(unsigned)first->hash, groups[g].count, (unsigned)first->size, (unsigned)groups[g].wasted);
+		for(int k = 0; k < groups[g].count; k++) {
+			printf("  %s#%d %.*s\n", job.files.paths[first[k].file], first[k].object,
+					OBJ_NAME_LEN, first[k].name);
+		}
+	}
+	printf("%d meshes in %d files, %d are copies, %u of %u mesh bytes wasted, in %.3fs\n",
+			total, job.files.count, copies, (unsigned)wasted, (unsigned)bytes, elapsed);
+	for(int w = 0; w < MAX_WORKERS; w++) free(job.bufs[w]);
+	free(groups);
+	free(all);
+	free(job.results);
+	file_list_free(&job.files);
+}
+
+int main(int argc, char *argv[]) {
+	int stats = STATS_OFF;
+	for(int i = 1; i < argc; i++) {
+		if(strcmp(argv[i], "--stats") == 0) stats = STATS_TEXT;
+		else if(strcmp(argv[i], "--stats=json") == 0) stats = STATS_JSON;
+		else continue;
+		memmove(&argv[i], &argv[i+1], (argc - i) * sizeof(char*));
+		argc--;
+		i--;
+	}
+	if(argc == 1) {
+		printf("USAGE: gloverModTools <action> <stuff>\n");
+		printf("View readme for more info\nEnter just the action to see the stuff. Actions include:\n");
+		//printf("  test:    verify load+save results in an exact match\n");
+		//printf("  texswap: rename textures\n");
+		//printf("  texwrap: list all textures with >1 UV\n");
+		//printf("  meshdel: delete meshes matching a name\n");
+		printf("  glo2txt: convert glo object models to text format\n");
+		printf("  txt2glo: convert text file back into binary glo\n");
+		printf("  glo2obj: export glo object models to wavefront obj\n");
+		printf("  obj2glo: import wavefront obj as a binary glo\n");
+		printf("  validate: check glo files or directories for corrupt data\n");
+		printf("  merge:   combine the objects of several glo files into one\n");
+		printf("  extract: copy meshes by name into a new glo file\n");
+		printf("  dedup:   find meshes that are copies of each other\n");
+		printf("  atlas:   move textures into atlases to cut draw calls\n");
+		printf("  decimate: reduce the number of faces of every mesh\n");
+		printf("  report:  bounds, counts and textures of every mesh\n");
+		printf("  transform: move, scale or rotate a model or some of its meshes\n");
+		printf("  pipeline: apply a script of edits to many glo files at once\n");
+		printf("  server:  keep running and take requests on stdin\n");
+		printf("  watch:   convert text models to glo whenever they're saved\n");
+		printf("Press enter to exit...\n");
+		getchar();
+		return 0;
+	}
+
+	//if(strcmp(argv[1], "test") == 0) do_test(argc-1, argv+1);
+	//if(strcmp(argv[1], "texswap") == 0) do_texswap(argc-1, argv+1);
+	//if(strcmp(argv[1], "texwrap") == 0) do_texwrap(argc-1, argv+1);
+	//if(strcmp(argv[1], "meshdel") == 0) do_meshdel(argc-1, argv+1);
+	if(strcmp(argv[1], "server") == 0) {
+		// Driven by another program, so no prompt to exit. Stats go to
+		// stderr, so they don't get mixed up with the replies.
+		do_server(argc-1, argv+1);
+		if(stats) print_stats(stats);
+		return 0;
+	}
+	if(strcmp(argv[1], "watch") == 0) {
+		// Only stopped by Ctrl+C, so there's no end to print stats at
+		if(stats) {
+			printf("--stats can't be used with watch.\n");
+			return 1;
+		}
+		do_watch(argc-1, argv+1);
+		return 0;
+	}
+	if(strcmp(argv[1], "glo2txt") == 0) do_glo2txt(argc-1, argv+1);
+	if(strcmp(argv[1], "txt2glo") == 0) do_txt2glo(argc-1, argv+1);
+	if(strcmp(argv[1], "glo2obj") == 0) do_glo2obj(argc-1, argv+1);
+	if(strcmp(argv[1], "obj2glo") == 0) do_obj2glo(argc-1, argv+1);
+	if(strcmp(argv[1], "validate") == 0) do_validate(argc-1, argv+1);
+	if(strcmp(argv[1], "merge") == 0) do_merge(argc-1, argv+1);
+	if(strcmp(argv[1], "extract") == 0) do_extract(argc-1, argv+1);
+	if(strcmp(argv[1], "dedup") == 0) do_dedup(argc-1, argv+1);
+	if(strcmp(argv[1], "atlas") == 0) do_atlas(argc-1, argv+1);
+	if(strcmp(argv[1], "decimate") == 0) do_decimate(argc-1, argv+1);
+	if(strcmp(argv[1], "report") == 0) do_report(argc-1, argv+1);
+	if(strcmp(argv[1], "transform") == 0) do_transform(argc-1, argv+1);
+	if(strcmp(argv[1], "pipeline") == 0) do_pipeline(argc-1, argv+1);
+	if(stats) print_stats(stats);
+
+	printf("\ndone! Press Enter to exit...");
+	getchar(); 
+	return exitcode;
 }